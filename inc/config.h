@@ -27,13 +27,44 @@ enum ConfigFlag {
     CONF_PCA_9685_PIN_BASE,
     CONF_PCA_9685_MAX_PWM,
     CONF_PCA_9685_HERTZ,
+    CONF_PCA_9685_BURST,
+    CONF_PCA_9685_I2C_BUS,
+    CONF_PCA_9685_ADDRESS,
+    CONF_PCA_9685_LIMITS_HERTZ,
+    CONF_PCA_9685_BOARDS,
+    CONF_SERVO_DRIVER,
 
     CONF_SERVOS_NUM,
     CONF_ROBOT_TICK,
+    CONF_ROBOT_REFRESH_TICKS,
+    CONF_ROBOT_PWM_SYNC,
+    CONF_ROBOT_PWM_LEAD,
+    CONF_ROBOT_UNIFIED_LOOP,
     CONF_TRANSITIONS_ENABLE,
     CONF_TRANSITIONS_TIME,
+    CONF_KEYFRAME_QUEUE_SIZE,
+    CONF_EASING_LUT,
+    CONF_KEYFRAME_SPLINE,
+    CONF_BLEND_TIME,
+    CONF_CPG_FREQUENCY,
+    CONF_CPG_SMOOTHING,
+    CONF_LEG_FEMUR_LENGTH,
+    CONF_LEG_TIBIA_LENGTH,
+    CONF_LEG_JOINT_RANGE,
+    CONF_LEG_KNEE_ZERO,
+    CONF_MOTION_LIBRARY,
     CONF_SERVO_PINS,
     CONF_SERVO_LIMITS,
+    CONF_JOINTS,
+
+    CONF_RT_ENABLE,
+    CONF_RT_MLOCKALL,
+    CONF_RT_ROBOT_PRIORITY,
+    CONF_RT_ROBOT_CPUS,
+    CONF_RT_KEYFR_PRIORITY,
+    CONF_RT_KEYFR_CPUS,
+    CONF_RT_EVENTS_PRIORITY,
+    CONF_RT_EVENTS_CPUS,
 
     CONF_WALK_HIP_DELTA,
     CONF_WALK_KNEE_DELTA,
@@ -44,6 +75,27 @@ enum ConfigFlag {
     CONF_HTTP_PORT
 };
 
+#define JOINT_NAME_MAXLEN 32
+#define CONFIG_PATH_MAXLEN 256
+#define JOINT_TAGS_MAXLEN 48
+
+/* One servo of the robot; board is an index into the PCA-9685 boards, tags are free-form leg/role labels. */
+typedef struct JointDesc {
+    char name[JOINT_NAME_MAXLEN];
+    unsigned short board;
+    unsigned short channel;
+    bool inverted;
+    ServoLimit limits;
+    char tags[JOINT_TAGS_MAXLEN];
+} JointDesc;
+
+/* A PCA-9685 board's location; boards left unconfigured fall back to pca_9685_i2c_bus and pca_9685_address + index. */
+typedef struct PCA9685Board {
+    bool configured;
+    unsigned short bus;
+    unsigned short address;
+} PCA9685Board;
+
 /* Config data struct */
 typedef struct Config {
     const char *log_file_dir;
@@ -61,14 +113,43 @@ typedef struct Config {
     unsigned int pca_9685_pin_base;
     unsigned int pca_9685_max_pwm;
     unsigned int pca_9685_hertz;
+    bool pca_9685_burst;
+    unsigned short pca_9685_i2c_bus;
+    unsigned short pca_9685_address;
+    unsigned int pca_9685_limits_hertz;
+    PCA9685Board *pca_9685_boards;
+    unsigned short servo_driver;
 
     unsigned short servos_num;
     double robot_tick;
+    unsigned short robot_refresh_ticks;
+    bool robot_pwm_sync;
+    double robot_pwm_lead;
+    bool robot_unified_loop;
     bool transitions_enable;
     double transition_time;
+    unsigned int keyframe_queue_size;
+    bool easing_lut;
+    bool keyframe_spline;
+    double blend_time;
+    double cpg_frequency;
+    double cpg_smoothing;
+    double leg_femur_length;
+    double leg_tibia_length;
+    double leg_joint_range;
+    double leg_knee_zero;
+    char motion_library[CONFIG_PATH_MAXLEN];
     
-    unsigned short *servo_pins;
-    ServoLimit *servo_limits;
+    JointDesc *joints;
+
+    bool rt_enable;
+    bool rt_mlockall;
+    unsigned short rt_robot_priority;
+    unsigned int rt_robot_cpus;
+    unsigned short rt_keyfr_priority;
+    unsigned int rt_keyfr_cpus;
+    unsigned short rt_events_priority;
+    unsigned int rt_events_cpus;
 
     double walk_hip_delta;
     double walk_knee_delta;
@@ -90,6 +171,12 @@ typedef struct ServoLimitData {
     unsigned short max;
 } ServoLimitData;
 
+typedef struct PCA9685BoardData {
+    unsigned short id;
+    unsigned short bus;
+    unsigned short address;
+} PCA9685BoardData;
+
 /* Initialize the application configuration, setting all variables. */
 void config_init(int argc, char *argv[]);
 
@@ -99,10 +186,13 @@ void config_destroy();
 /* Set the variable correlating the identifier (a value from the ConfigFlag enum) to a data object. */ 
 void config_set(unsigned short config_var, void *data, bool is_string);
 
+/* Return a counter bumped on every config_set, so derived tables can tell when to rebuild. */
+unsigned int config_get_version();
+
 /* Return a generic data object representing the value of the given configuration var identifier. */
 void *config_get(unsigned short config_var);
 
-/* Get the integer value of a servo index from a string. */
+/* Get the index of the joint with the given name; -1 if there is none. */
 unsigned short config_str_to_servo_index(const char *str);
 
 #endif
\ No newline at end of file
@@ -26,6 +26,18 @@
 #define DEFAULT_PCA_9685_PIN_BASE 300
 #define DEFAULT_PCA_9685_MAX_PWM 4096
 #define DEFAULT_PCA_9685_HERTZ 50
+#define DEFAULT_PCA_9685_BURST 1
+#define DEFAULT_PCA_9685_I2C_BUS 1
+#define DEFAULT_PCA_9685_ADDRESS 0x40
+#define DEFAULT_PCA_9685_LIMITS_HERTZ 0
+
+/* Servo output backend; host builds have no wiringPi, so they default to the simulator. */
+#ifdef PEABOT_HOST
+#define DEFAULT_SERVO_DRIVER SERVO_DRIVER_SIM
+#else
+#define DEFAULT_SERVO_DRIVER SERVO_DRIVER_PCA9685
+#endif
+#define DEFAULT_SIM_LOG_SIZE 8192
 
 /* HRC-SR04 config */
 #define DEFAULT_HRC_SR04_ECHO_PIN 26
@@ -33,9 +45,36 @@
 
 /* Robot related*/
 #define DEFAULT_SERVOS_NUM 8
+#define DEFAULT_JOINTS_MAX 64
+#define DEFAULT_PCA_9685_BOARDS_MAX 8
 #define DEFAULT_ROBOT_TICK 0.01
+#define DEFAULT_ROBOT_REFRESH_TICKS 100
+#define DEFAULT_ROBOT_PWM_SYNC 0
+#define DEFAULT_ROBOT_PWM_LEAD 0.0015
+#define DEFAULT_ROBOT_UNIFIED_LOOP 0
 #define DEFAULT_TRANSITIONS_ENABLE 1
 #define DEFAULT_KEYFRAME_TRANSITION_TIME 1.0
+#define DEFAULT_KEYFRAME_QUEUE_SIZE 512
+#define DEFAULT_EASING_LUT 0
+#define DEFAULT_KEYFRAME_SPLINE 0
+#define DEFAULT_BLEND_TIME 0.15
+#define DEFAULT_CPG_FREQUENCY 1.0
+#define DEFAULT_CPG_SMOOTHING 0.25
+#define DEFAULT_LEG_FEMUR_LENGTH 55.0
+#define DEFAULT_LEG_TIBIA_LENGTH 75.0
+#define DEFAULT_LEG_JOINT_RANGE 1.5708
+#define DEFAULT_LEG_KNEE_ZERO 1.5708
+#define DEFAULT_MOTION_LIBRARY "etc/motions.json"
+
+/* Real-time scheduling; a CPU mask of 0 leaves the thread's affinity untouched. */
+#define DEFAULT_RT_ENABLE 0
+#define DEFAULT_RT_MLOCKALL 1
+#define DEFAULT_RT_ROBOT_PRIORITY 80
+#define DEFAULT_RT_ROBOT_CPUS 0
+#define DEFAULT_RT_KEYFR_PRIORITY 70
+#define DEFAULT_RT_KEYFR_CPUS 0
+#define DEFAULT_RT_EVENTS_PRIORITY 50
+#define DEFAULT_RT_EVENTS_CPUS 0
 
 /* Walk related */
 #define DEFAULT_HIP_DELTA 0.7
@@ -53,6 +92,12 @@
 #define DEFAULT_FRONT_RIGHT_KNEE 6
 #define DEFAULT_FRONT_RIGHT_HIP 7
 
+/* Default joint names and tags, by SERVO_INDEX_* */
+#define DEFAULT_JOINT_NAMES { "back_left_knee", "back_left_hip", "front_left_knee", "front_left_hip", \
+    "back_right_knee", "back_right_hip", "front_right_knee", "front_right_hip" }
+#define DEFAULT_JOINT_TAGS { "leg=back_left,role=knee", "leg=back_left,role=hip", "leg=front_left,role=knee", "leg=front_left,role=hip", \
+    "leg=back_right,role=knee", "leg=back_right,role=hip", "leg=front_right,role=knee", "leg=front_right,role=hip" }
+
 /* Servo limits */
 #define DEFAULT_SERVO_MIN 200
 #define DEFAULT_SERVO_MAX 400
@@ -8,6 +8,8 @@
  Author:        Matt Mumau
  */
 
+#define CONFIG_FILE_LIMITS_SUFFIX "_limits"
+
 /* Load the configuration file and set configuration variables from it. */
 void configfile_process(char *config_file_fullpath);
 
@@ -34,15 +34,72 @@ void configset_pca_9685_pin_base(Config *config, void *data, bool is_string);
 void configset_pca_9685_max_pwm(Config *config, void *data, bool is_string);
 /* Set the PCA-9685's frequency value; takes an int pointer, cast to a void pointer. */
 void configset_pca_9685_hertz(Config *config, void *data, bool is_string);
+/* Set whether to write servo frames in one I2C burst instead of through wiringPi; takes a bool pointer, cast to a void pointer. */
+void configset_pca_9685_burst(Config *config, void *data, bool is_string);
+/* Set the I2C bus number (/dev/i2c-N) of the PCA-9685; takes a short pointer, cast to a void pointer. */
+void configset_pca_9685_i2c_bus(Config *config, void *data, bool is_string);
+/* Set the I2C address of the PCA-9685; takes a short pointer, or a decimal or hex string. */
+void configset_pca_9685_address(Config *config, void *data, bool is_string);
+/* Set the PWM frequency the servo limits are given at, 0 for pca_9685_hertz; takes an int pointer, cast to a void pointer. */
+void configset_pca_9685_limits_hertz(Config *config, void *data, bool is_string);
+/* Set the servo output backend; takes a short pointer, or the string "pca9685" or "sim". */
+void configset_servo_driver(Config *config, void *data, bool is_string);
 
 /* Set the number of robot servos; takes an int pointer, cast to a void pointer. */
 void configset_servos_num(Config *config, void *data, bool is_string);
 /* Set speed of the robot's tick; takes a float pointer, cast to a void pointer. */
 void configset_robot_tick(Config *config, void *data, bool is_string);
+/* Set how many ticks pass between full servo refreshes, 0 to only write changes; takes a short pointer, cast to a void pointer. */
+void configset_robot_refresh_ticks(Config *config, void *data, bool is_string);
+/* Set whether the output tick follows the PWM frame period of the servo driver; takes a bool pointer, cast to a void pointer. */
+void configset_robot_pwm_sync(Config *config, void *data, bool is_string);
+/* Set how many seconds before each PWM frame the synchronized output is written; takes a float pointer, cast to a void pointer. */
+void configset_robot_pwm_lead(Config *config, void *data, bool is_string);
+/* Set whether keyframes are evaluated on the robot output tick instead of their own thread; takes a bool pointer, cast to a void pointer. */
+void configset_robot_unified_loop(Config *config, void *data, bool is_string);
 /* Set whether to enable transition motions; takes a bool pointer, cast to a void pointer. */
 void configset_transitions_enable(Config *config, void *data, bool is_string);
 /* Set the length of transition motions in seconds; takes a float pointer, cast to a void pointer. */
 void configset_transition_time(Config *config, void *data, bool is_string);
+/* Set how many keyframes the keyframe queue holds; takes an int pointer, cast to a void pointer. */
+void configset_keyframe_queue_size(Config *config, void *data, bool is_string);
+/* Set whether easings are evaluated from interpolated lookup tables; takes a bool pointer, cast to a void pointer. */
+void configset_easing_lut(Config *config, void *data, bool is_string);
+/* Set whether keyframes are chained through a C1 spline instead of transition keyframes; takes a bool pointer, cast to a void pointer. */
+void configset_keyframe_spline(Config *config, void *data, bool is_string);
+/* Set the time in seconds over which the first command after a halt cross-fades from the current pose, 0 to disable; takes a float pointer, cast to a void pointer. */
+void configset_blend_time(Config *config, void *data, bool is_string);
+/* Set the step frequency of the oscillator gait in cycles per second; takes a float pointer, cast to a void pointer. */
+void configset_cpg_frequency(Config *config, void *data, bool is_string);
+/* Set the time constant in seconds with which the oscillator gait follows a new command; takes a float pointer, cast to a void pointer. */
+void configset_cpg_smoothing(Config *config, void *data, bool is_string);
+/* Set the length of the leg link from hip to knee, in mm; takes a float pointer, cast to a void pointer. */
+void configset_leg_femur_length(Config *config, void *data, bool is_string);
+/* Set the length of the leg link from knee to foot, in mm; takes a float pointer, cast to a void pointer. */
+void configset_leg_tibia_length(Config *config, void *data, bool is_string);
+/* Set the joint angle in radians reached at a servo position of 1; takes a float pointer, cast to a void pointer. */
+void configset_leg_joint_range(Config *config, void *data, bool is_string);
+/* Set the knee bend in radians at a servo position of 0; takes a float pointer, cast to a void pointer. */
+void configset_leg_knee_zero(Config *config, void *data, bool is_string);
+/* Set the path of the JSON motion library; takes a string, which is copied. */
+void configset_motion_library(Config *config, void *data, bool is_string);
+
+/* Set whether to run the control threads with real-time scheduling; takes a bool pointer, cast to a void pointer. */
+void configset_rt_enable(Config *config, void *data, bool is_string);
+/* Set whether to lock the process' memory in real-time mode; takes a bool pointer, cast to a void pointer. */
+void configset_rt_mlockall(Config *config, void *data, bool is_string);
+/* Set the SCHED_FIFO priority of the robot thread; takes a short pointer, cast to a void pointer. */
+void configset_rt_robot_priority(Config *config, void *data, bool is_string);
+/* Set the CPU set of the robot thread; takes an int mask pointer, or a list such as "0,2-3". */
+void configset_rt_robot_cpus(Config *config, void *data, bool is_string);
+/* Set the SCHED_FIFO priority of the keyframe thread; takes a short pointer, cast to a void pointer. */
+void configset_rt_keyfr_priority(Config *config, void *data, bool is_string);
+/* Set the CPU set of the keyframe thread; takes an int mask pointer, or a list such as "0,2-3". */
+void configset_rt_keyfr_cpus(Config *config, void *data, bool is_string);
+/* Set the SCHED_FIFO priority of the events thread; takes a short pointer, cast to a void pointer. */
+void configset_rt_events_priority(Config *config, void *data, bool is_string);
+/* Set the CPU set of the events thread; takes an int mask pointer, or a list such as "0,2-3". */
+void configset_rt_events_cpus(Config *config, void *data, bool is_string);
 
 /* Set the magnitude of the hip during the walk motion; takes a float pointer, cast to a void pointer. */
 void configset_walk_hip_delta(Config *config, void *data, bool is_string);
@@ -57,6 +114,10 @@ void configset_walk_knee_pad_b(Config *config, void *data, bool is_string);
 void configset_servo_pins(Config *config, void *data, bool is_string);
 /* Set the servo PWM limits for a given robot position; takes a ServoLimitData pointer, cast to a void pointer. */
 void configset_servo_limits(Config *config, void *data, bool is_string);
+/* Add or replace a joint descriptor, matched by name; takes a JointDesc pointer or a "name board channel inverted min-max [tags]" string. */
+void configset_joints(Config *config, void *data, bool is_string);
+/* Set the bus and address of a PCA-9685 board; takes a PCA9685BoardData pointer or an "index bus address" string. */
+void configset_pca_9685_boards(Config *config, void *data, bool is_string);
 
 /* Set whether or not to enable the HTTP server. */
 void configset_http_enabled(Config *config, void *data, bool is_string);
@@ -30,4 +30,8 @@ bool cntlevent_halt(MVCData *mvc_data);
 
 bool cntlevent_strafe(MVCData *mvc_data);
 
+bool cntlevent_gait(MVCData *mvc_data);
+
+bool cntlevent_motion(MVCData *mvc_data);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,20 @@
+#ifndef CONTROLLER_TIMING_H_DEF
+#define CONTROLLER_TIMING_H_DEF
+
+/*
+ File:          controller_timing.h
+ Description:   Controller functions for the control loop timing statistics.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+/* System includes */
+#include <stdbool.h>
+
+/* Add each stage's latency histogram summary and the output loop's overrun counts to the response. */
+bool cntltiming_getval(MVCData *mvc_data);
+
+/* Clear the latency histograms. */
+bool cntltiming_reset(MVCData *mvc_data);
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef CPG_GAIT_H_DEF
+#define CPG_GAIT_H_DEF
+
+/*
+ File:          cpg_gait.h
+ Description:   Trot gait computed per tick from a phase oscillator, steered by
+                continuous velocity commands instead of queued keyframes.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+#include "precision.h"
+
+#define CPG_LEGS 4
+#define CPG_KNEE_STANCE 0.8
+
+/*
+ Velocities are fractions of a full stride, -1 to 1; forward and lateral follow the walk and strafe
+ directions, yaw turns on the spot. step_height is the fraction of the walk's knee lift, 0 to 1.
+ */
+typedef struct CpgCommand {
+    double forward;
+    double lateral;
+    double yaw;
+    double step_height;
+} CpgCommand;
+
+/* Reset the oscillator; the gait starts inactive. */
+void cpg_init();
+
+/* Any thread; steer the gait, starting it if it is not running. The new command is followed smoothly, even mid-stride. */
+void cpg_set_command(const CpgCommand *command);
+
+/* Any thread; stop the gait where it is. */
+void cpg_stop();
+
+/* Whether the gait is driving the joints. */
+bool cpg_active();
+
+/* 
+ Stepping thread; advance the oscillator to time and write every joint's position into pos, which holds len values. 
+ True if the gait was started since the last call, however briefly it was stopped, and restarted from rest. 
+ */
+bool cpg_eval(const struct timespec *time, AnimReal *pos, size_t len);
+
+#endif
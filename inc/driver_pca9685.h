@@ -0,0 +1,31 @@
+#ifndef DRIVER_PCA9685_H_DEF
+#define DRIVER_PCA9685_H_DEF
+
+/*
+ File:          driver_pca9685.h
+ Description:   Servo driver backend for the PCA-9685, through I2C bursts or wiringPi.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#include <time.h>
+
+/* wiringPi pins taken by each board: its 16 channels and the all-channels pin. */
+#define DRVPCA_PIN_STRIDE 17
+
+/* Open boards_num PCA-9685 boards as configured by the pca_9685_* variables. */
+int drvpca_init(unsigned short boards_num);
+
+/* Write the dirty channels of the frame to the given PCA-9685 board. */
+int drvpca_write(unsigned short board, const unsigned short *frame, unsigned int dirty_mask);
+
+/* The prescaled PWM period at a nominal 25 MHz, and when board 0's counter was restarted; only known in burst mode. */
+int drvpca_frame_timing(long long *period_ns, struct timespec *frame_start);
+
+/* Turn every channel of every PCA-9685 off. */
+void drvpca_reset();
+
+/* Close the PCA-9685 boards. */
+void drvpca_halt();
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef DRIVER_SIM_H_DEF
+#define DRIVER_SIM_H_DEF
+
+/*
+ File:          driver_sim.h
+ Description:   Simulated PCA-9685 servo driver backend, which records every channel 
+                write in memory with a timestamp.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+typedef struct SimServoWrite {
+    struct timespec time;
+    unsigned short board;
+    unsigned short channel;
+    unsigned short count;
+} SimServoWrite;
+
+/* Allocate the simulator's write log for boards_num simulated boards. */
+int drvsim_init(unsigned short boards_num);
+
+/* Record the dirty channels of the frame written to the given board. */
+int drvsim_write(unsigned short board, const unsigned short *frame, unsigned int dirty_mask);
+
+/* The period a PCA-9685 would run at for pca_9685_hertz, with frames starting at init. */
+int drvsim_frame_timing(long long *period_ns, struct timespec *frame_start);
+
+/* Record every channel being turned off. */
+void drvsim_reset();
+
+/* Free the simulator's write log. */
+void drvsim_halt();
+
+/* Get the current count of a simulated channel. */
+unsigned short drvsim_get_channel(unsigned short board, unsigned short channel);
+
+/* Get the total number of channel writes recorded, including those which have rotated out of the log. */
+unsigned long drvsim_get_write_count();
+
+/* Copy up to len of the most recent writes into dest, oldest first; returns the number copied. */
+size_t drvsim_get_writes(SimServoWrite *dest, size_t len);
+
+/* Write the log as CSV lines of "seconds,board,channel,count"; returns the number of lines written. */
+size_t drvsim_dump(FILE *file);
+
+#endif
@@ -17,7 +17,14 @@
 #define AH_EASING_USE_DBL_PRECIS
 #endif
 
+#include "precision.h"
+
+// Double for the double build, single precision for the float and Q16 builds.
+#if PEABOT_PRECISION == PRECISION_DOUBLE
 #define AH_FLOAT_TYPE double
+#else
+#define AH_FLOAT_TYPE float
+#endif
 
 typedef AH_FLOAT_TYPE AHFloat;
 
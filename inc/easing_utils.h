@@ -9,6 +9,8 @@
  */
 
 /* System includes */
+#include <stdbool.h>
+
 #include "easing.h"
 
 #define EASE_LINEAR 0
@@ -53,6 +55,30 @@
 #define EASE_BOUNCE_OUT 29
 #define EASE_BOUNCE_INOUT 30
 
+#define EASE_NUM 31
+
+#define EASING_LUT_SIZE 256
+#define EASING_LUT_MAXERR 0.001
+
+/* Build the lookup tables if use_lut is set, and evaluate every easing through them from then on; returns 0 or an errno value. */
+int easing_init(bool use_lut);
+
+/* Free the lookup tables and go back to evaluating the easing functions directly. */
+void easing_destroy();
+
+/* Evaluate an easing at p, through its lookup table if tables are enabled and it is within EASING_LUT_MAXERR; unknown easings are linear. */
 double easing_calc(unsigned short easing_type, AHFloat p);
 
+/* Evaluate an easing by calling its function. */
+double easing_calc_direct(unsigned short easing_type, AHFloat p);
+
+/* Evaluate an easing by interpolating its lookup table, which must have been built. */
+double easing_calc_lut(unsigned short easing_type, AHFloat p);
+
+/* Build the lookup tables without enabling them, if they are not built yet; returns 0 or an errno value. */
+int easing_lut_build();
+
+/* The largest difference from the direct function measured for an easing's table when it was built. */
+double easing_lut_maxerr(unsigned short easing_type);
+
 #endif
\ No newline at end of file
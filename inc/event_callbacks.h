@@ -32,4 +32,10 @@ void eventcb_halt(void *arg);
 /* Event to move the robot laterally. */
 void eventcb_strafe(void *arg);
 
+/* Event to steer the oscillator gait, taking over from any queued keyframes when it starts. */
+void eventcb_gait(void *arg);
+
+/* Event to play a motion from the motion library. */
+void eventcb_motion(void *arg);
+
 #endif
\ No newline at end of file
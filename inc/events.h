@@ -18,6 +18,10 @@
 #define EVENT_EXTEND 5
 #define EVENT_TURN 6
 #define EVENT_STRAFE 7
+#define EVENT_GAIT 8
+#define EVENT_MOTION 9
+
+#define EVENT_MOTION_NAME_MAXLEN 32
 
 typedef struct Event {
     unsigned short type;
@@ -52,6 +56,18 @@ typedef struct EventStrafeData {
     bool reverse;
 } EventStrafeData;
 
+typedef struct EventGaitData {
+    double forward;
+    double lateral;
+    double yaw;
+    double step_height;
+} EventGaitData;
+
+typedef struct EventMotionData {
+    char name[EVENT_MOTION_NAME_MAXLEN];
+    unsigned short cycles;
+} EventMotionData;
+
 /* Initialize the event handler thread. */
 void event_init();
 
@@ -12,6 +12,18 @@
 
 #include "keyframe_handler.h"
 
+/*
+ Where a robot is in the generated motions: the phase, 0 or 1, of the KEYFR_WALK and KEYFR_STRAFE 
+ gaits, and the next leg of a KEYFR_TURN with the legs that have already swung. Each robot, or each 
+ sequence generated ahead of time, keeps its own.
+ */
+typedef struct GaitState {
+    unsigned short walk_phase;
+    unsigned short strafe_phase;
+    unsigned short turn_leg;
+    bool turn_legs_complete[4];
+} GaitState;
+
 /* Get keyframe for resetting the robot to the home position. */
 bool keyfactory_reset(Keyframe *keyfr, size_t len, void *data, bool reverse);
 
@@ -24,14 +36,24 @@ bool keyfactory_elevate(Keyframe *keyfr, size_t len, void *data, bool reverse);
 /* Get a keyframe for extending or retracting the hip servos. */
 bool keyfactory_extend(Keyframe *keyfr, size_t len, void *data, bool reverse);
 
-/* Get keyframe to add a walk animation. */
-bool keyfactory_walk(Keyframe *keyfr, size_t len, void *data, bool reverse);
+/* Set a gait state to where a robot starts: both gaits at phase 0 and no turn under way. */
+void keyfactory_gait_init(GaitState *state);
 
-/* Get a single segment of a turn animation (one leg). */
-bool keyfactory_turnsegment(Keyframe *keyfr, size_t len, void *data, bool reverse);
+/* Get the phase, 0 or 1, of the next keyframe of a KEYFR_WALK or KEYFR_STRAFE gait from state. */
+unsigned short keyfactory_gait_phase(const GaitState *state, unsigned short keyfr_type);
 
-/* Get a keyframe for a transition between the src and dest ServoPos objects. */
-bool keyfactory_strafe(Keyframe *keyfr, size_t len, void *data, bool reverse);
+/* Get a KEYFR_WALK or KEYFR_STRAFE keyframe for the given phase. */
+bool keyfactory_gait(Keyframe *keyfr, size_t len, unsigned short keyfr_type, double duration, bool reverse, unsigned short phase);
+
+/* Write to next the state after one more KEYFR_WALK, KEYFR_STRAFE or KEYFR_TURN keyframe from state. */
+void keyfactory_advance(const GaitState *state, GaitState *next, unsigned short keyfr_type, bool reverse);
+
+/*
+ Get the next KEYFR_WALK, KEYFR_STRAFE or KEYFR_TURN keyframe from state, and write the state after it to next; the keyframe's 
+ duration, is_delay and servo positions are all written. Nothing but the arguments is read or written, so any thread may 
+ generate from its own state; state and next may be the same.
+ */
+bool keyfactory_next(const GaitState *state, GaitState *next, Keyframe *keyfr, size_t len, unsigned short keyfr_type, double duration, bool reverse);
 
 /* Get a keyframe for a transition between the src and dest ServoPos objects. */
 bool keyfactory_transition(Keyframe *keyfr, size_t len, Keyframe *src, Keyframe *dest);
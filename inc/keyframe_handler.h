@@ -9,6 +9,10 @@
  */
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+#include "precision.h"
 
 #define KEYFR_RESET 0
 #define KEYFR_DELAY 1
@@ -17,6 +21,10 @@
 #define KEYFR_EXTEND 4
 #define KEYFR_TURN 5
 #define KEYFR_STRAFE 6
+#define KEYFR_LIBRARY 7
+
+/* Ticks a redirect waits for the stepping side to drop the keyframes it cleared. */
+#define KEYHANDLER_REDIRECT_TICKS 3
 
 typedef struct ServoPos {
     unsigned short easing;
@@ -26,11 +34,33 @@ typedef struct ServoPos {
     double end_pad;   
 } ServoPos;
 
-/* Data structure for representing servo positions at a point in time. */
+/* 
+ A keyframe's servo positions baked into one array per field, for the per-tick kernel; a joint's 
+ progress is time * scale + offset, clamped to 0 to 1, and its position start + delta * eased progress. 
+ */
+typedef struct KeyframeLanes {
+    AnimReal *scale;
+    AnimReal *offset;
+    AnimReal *start;
+    AnimReal *delta;
+    unsigned short *easing;
+} KeyframeLanes;
+
+/* 
+ Data structure for representing servo positions at a point in time; motion or library is set when servo_pos and lanes 
+ are shared from the motion cache or the motion library, and preempt when the keyframe cross-fades in from the pose the robot was left at by a halt or redirect. 
+ start_ns is its scheduled start on the handler's monotonic timeline.
+ */
 typedef struct Keyframe {
     double duration;
     bool is_delay;
+    bool preempt;
+    unsigned int epoch;
+    long long start_ns;
     ServoPos *servo_pos;
+    KeyframeLanes lanes;
+    struct MotionEntry *motion;
+    struct MotionLibrary *library;
 } Keyframe;
 
 /* Initialize the keyframe handler process. */
@@ -39,11 +69,28 @@ void keyhandler_init();
 /* End the keyframe process thread and stop processing keyframes. */
 void keyhandler_halt();
 
-/* Add a keyframe to the keyframe queue. */
-void keyhandler_add(unsigned short keyfr_type, void *data, bool reverse, bool skip_transitions);
+/* 
+ Add a keyframe, and its transition, to the keyframe queue; false if it could not be built or the queue is full. 
+ Takes ownership of data. Stops the oscillator gait if it is running, once the keyframe is queued. 
+ */
+bool keyhandler_add(unsigned short keyfr_type, void *data, bool reverse, bool skip_transitions);
+
+/* Get the number of free slots in the keyframe queue. */
+size_t keyhandler_space();
 
+/* Drop every queued keyframe; anything added after this call is kept. Safe from any thread. */
 void keyhandler_removeall();
 
+/* 
+ Drop the motion in flight so the next keyframe added cross-fades from the current pose instead of queueing 
+ behind it; true if there was one, and then its slots are free again within a few ticks. Does nothing with 
+ blend_time 0. Call from the adding thread before a command's keyframes. 
+ */
+bool keyhandler_redirect();
+
+/* Get the CLOCK_MONOTONIC time at which everything queued so far is predicted to have finished; now if the queue is idle. */
+void keyhandler_completion(struct timespec *done);
+
 void keyhandler_print_keyfr(Keyframe *keyfr, size_t len);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef KEYFRAME_KERNEL_H_DEF
+#define KEYFRAME_KERNEL_H_DEF
+
+/*
+ File:          keyframe_kernel.h
+ Description:   Baking of keyframes into lanes, and the per-tick kernel evaluating them.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#include <stddef.h>
+
+#include "precision.h"
+#include "keyframe_handler.h"
+
+/* Accuracy and speed of the kernel in the build's precision, measured by kfkernel_bench. */
+typedef struct KernelBench {
+    double max_err;
+    double mean_err;
+    double eval_ns;
+    unsigned long evals;
+} KernelBench;
+
+/* One segment of the spline through keyframe targets; every joint runs from from to to over duration, leaving with velocity m0 and arriving with m1. */
+typedef struct SplineSegment {
+    double *from;
+    double *to;
+    double *m0;
+    double *m1;
+    double duration;
+} SplineSegment;
+
+/* Fill the keyframe's lanes from its servo positions and duration; done once, when it is queued. */
+void kfkernel_bake(Keyframe *keyfr, size_t len);
+
+/* Write every joint's position at time into pos, using perc as scratch; both hold len values. */
+void kfkernel_eval(const KeyframeLanes *lanes, double time, AnimReal *restrict perc, AnimReal *restrict pos, size_t len);
+
+/* Write every joint's position at time along a spline segment into pos; pos holds len values. */
+void kfkernel_spline_eval(const SplineSegment *segment, double time, AnimReal *restrict pos, size_t len);
+
+/* Evaluate random keyframes of len joints through the kernel against a double reference, then time rounds evaluations; returns 0 or an errno value. */
+int kfkernel_bench(size_t len, unsigned int rounds, KernelBench *bench);
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef KEYFRAME_POOL_H_DEF
+#define KEYFRAME_POOL_H_DEF
+
+/*
+ File:          keyframe_pool.h
+ Description:   Fixed pool of keyframes, each stored with its servo positions in 
+                one cache-line-aligned block.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#include <stddef.h>
+
+#include "ring_buffer.h"
+#include "keyframe_handler.h"
+
+#define KEYFRAME_POOL_ALIGN 64
+#define KEYFRAME_POOL_SLACK 3
+
+typedef struct KeyframePool {
+    unsigned char *slab;
+    size_t block_size;
+    size_t capacity;
+    size_t servos_num;
+    Keyframe *spare;
+    RingBuffer free_blocks;
+} KeyframePool;
+
+/* Allocate capacity blocks, each holding a keyframe, servos_num servo positions and their lanes; returns 0 or an errno value. */
+int kfpool_init(KeyframePool *pool, size_t capacity, size_t servos_num);
+
+/* Free the slab; every keyframe taken from the pool becomes invalid. */
+void kfpool_destroy(KeyframePool *pool);
+
+/* Allocating thread; take a zeroed keyframe with its servo_pos and lanes pointing into its own block, NULL if the pool is empty. */
+Keyframe *kfpool_alloc(KeyframePool *pool);
+
+/* Allocating thread; give back a keyframe which was never handed to another thread. Holds one block at a time. */
+void kfpool_discard(KeyframePool *pool, Keyframe *keyfr);
+
+/* Retiring thread; return a keyframe taken from the pool once it is finished with. */
+void kfpool_free(KeyframePool *pool, Keyframe *keyfr);
+
+/* Get the number of keyframes which can still be taken. */
+size_t kfpool_available(KeyframePool *pool);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef LEG_IK_H_DEF
+#define LEG_IK_H_DEF
+
+/*
+ File:          leg_ik.h
+ Description:   Inverse kinematics for a two link leg, turning foot positions into
+                hip and knee servo positions through a precomputed grid. Only the
+                ik_bench prompt command uses it so far; no motion is authored in
+                foot space yet.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#include <stdbool.h>
+
+#define LEGIK_GRID_SIZE 64
+
+/*
+ Hip and knee servo positions, -1 to 1. The hip angle is the femur's swing from straight down,
+ positive forward; the knee angle is its bend away from straight, with the knee pointing back.
+ */
+typedef struct LegJoints {
+    double hip;
+    double knee;
+} LegJoints;
+
+/* Accuracy and cost of the grid against the direct solution, over reachable foot positions. */
+typedef struct LegIkBench {
+    double max_err;
+    double mean_err;
+    double solve_ns;
+    double lookup_ns;
+    unsigned long samples;
+} LegIkBench;
+
+/*
+ Solve directly for a foot x mm forward of the hip and z mm below it. A foot out of reach is moved
+ along the line from the hip to the nearest reachable point; returns false if it had to be.
+ */
+bool legik_solve(double x, double z, LegJoints *joints);
+
+/*
+ The same from the grid, interpolated between the four nearest points; any thread, and it never builds. The
+ grid covers the leg's full reach in front of, behind and below the hip.
+ */
+void legik_lookup(double x, double z, LegJoints *joints);
+
+/* Rebuild the grid if the leg lengths or joint ranges differ from the ones it was built from. */
+void legik_build();
+
+/* Compare the grid with the direct solution at samples^2 reachable foot positions, and time both. */
+void legik_bench(unsigned int samples, LegIkBench *bench);
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef MOTION_CACHE_H_DEF
+#define MOTION_CACHE_H_DEF
+
+/*
+ File:          motion_cache.h
+ Description:   Cache of built and baked gait keyframes, which queued keyframes share 
+                by reference instead of being rebuilt every cycle.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#include "keyframe_handler.h"
+#include "keyframe_pool.h"
+
+#define MOTION_CACHE_SIZE 16
+
+/* What a cached keyframe was built from; version is the config version at the time. */
+typedef struct MotionKey {
+    unsigned short type;
+    bool reverse;
+    unsigned short phase;
+    double duration;
+    unsigned int version;
+} MotionKey;
+
+typedef struct MotionEntry {
+    MotionKey key;
+    bool valid;
+    unsigned long last_used;
+    atomic_uint refs;
+    Keyframe *keyfr;
+} MotionEntry;
+
+/* Hit and miss counts, and how often no entry was free to cache into. */
+typedef struct MotionCacheStats {
+    unsigned long hits;
+    unsigned long misses;
+    unsigned long bypassed;
+} MotionCacheStats;
+
+/* Allocate every entry, each holding a keyframe of servos_num positions and its lanes; returns 0 or an errno value. */
+int motcache_init(size_t servos_num);
+
+/* Free the entries; nothing may still reference them. */
+void motcache_destroy();
+
+/* 
+ Adding thread; take a reference to the entry for key. On a hit its keyframe is ready to share; on a miss 
+ the caller must build and bake it, or give it up with motcache_discard. NULL if every entry is in use. 
+ */
+MotionEntry *motcache_acquire(const MotionKey *key, bool *hit);
+
+/* Adding thread; drop an entry whose keyframe could not be built. */
+void motcache_discard(MotionEntry *entry);
+
+/* Any thread; drop a reference taken by motcache_acquire once the keyframe sharing it is finished with. */
+void motcache_release(MotionEntry *entry);
+
+/* Copy the cache's counters into stats. */
+void motcache_get_stats(MotionCacheStats *stats);
+
+#endif
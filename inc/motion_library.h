@@ -0,0 +1,70 @@
+#ifndef MOTION_LIBRARY_H_DEF
+#define MOTION_LIBRARY_H_DEF
+
+/*
+ File:          motion_library.h
+ Description:   Motions defined in a JSON file, validated and baked once when loaded,
+                and swapped out whole when the file is reloaded.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#include "keyframe_handler.h"
+#include "keyframe_pool.h"
+
+#define MOTION_NAME_MAXLEN 32
+
+/* A named motion; its frames are frames_num consecutive keyframes from first in the library. */
+typedef struct LibraryMotion {
+    char name[MOTION_NAME_MAXLEN];
+    size_t first;
+    size_t frames_num;
+} LibraryMotion;
+
+/* One load of the file. Queued keyframes share its baked frames, each holding a reference. */
+typedef struct MotionLibrary {
+    atomic_uint refs;
+    struct MotionLibrary *next_dead;
+    unsigned int generation;
+    LibraryMotion *motions;
+    size_t motions_num;
+    Keyframe **frames;
+    size_t frames_num;
+    KeyframePool pool;
+} MotionLibrary;
+
+/* What a KEYFR_LIBRARY keyframe is built from; the keyframe takes a reference of its own to library. */
+typedef struct LibraryFrameRef {
+    MotionLibrary *library;
+    size_t frame;
+} LibraryFrameRef;
+
+/* Load the file named by motion_library; a missing or invalid file leaves the library empty. Returns 0 or an errno value. */
+int motlib_init(size_t servos_num);
+
+/* Drop the current library and free every library no longer in use; call once no keyframe holds one. */
+void motlib_destroy();
+
+/* Load the file again and swap it in; on any error the current library is kept. Returns 0 or an errno value. */
+int motlib_reload();
+
+/* Take a reference to the current library, NULL if none is loaded. */
+MotionLibrary *motlib_acquire();
+
+/* Take another reference to a library already held. */
+void motlib_retain(MotionLibrary *library);
+
+/*
+ Any thread; drop a reference. The last one only queues the library, and it is freed by the
+ next acquire, reload or destroy, so the stepping thread never frees memory.
+ */
+void motlib_release(MotionLibrary *library);
+
+/* Find a motion by name, NULL if the library has none by that name. */
+const LibraryMotion *motlib_find(const MotionLibrary *library, const char *name);
+
+#endif
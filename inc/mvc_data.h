@@ -12,6 +12,7 @@
 #define MODEL_EVENT 1
 #define MODEL_USD 2
 #define MODEL_POSITION 3
+#define MODEL_TIMING 4
 
 #define CONTROLLER_NONE 0
 #define CONTROLLER_WALK 1
@@ -23,6 +24,8 @@
 #define CONTROLLER_GET 7
 #define CONTROLLER_HALT 8
 #define CONTROLLER_STRAFE 9
+#define CONTROLLER_GAIT 10
+#define CONTROLLER_MOTION 11
 
 /* Application includes */
 #include "http_request.h"
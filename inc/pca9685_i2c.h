@@ -0,0 +1,46 @@
+#ifndef PCA9685_I2C_H_DEF
+#define PCA9685_I2C_H_DEF
+
+/*
+ File:          pca9685_i2c.h
+ Description:   Direct /dev/i2c-N access to the PCA-9685, writing whole frames of 
+                channels in one auto-incremented I2C transaction.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#include <time.h>
+
+#define PCA9685_CHANNELS 16
+#define PCA9685_COUNT_MAX 4096
+#define PCA9685_OSC_HERTZ 25000000.0
+
+/* restarted is when the PWM counter last restarted from 0, on CLOCK_MONOTONIC. */
+typedef struct PCA9685Dev {
+    int fd;
+    unsigned short address;
+    struct timespec restarted;
+} PCA9685Dev;
+
+/* Open the PCA-9685 at the given address on /dev/i2c-<bus>, enable auto-increment and set its frequency; returns 0 or an errno value. */
+int pcai2c_open(PCA9685Dev *dev, unsigned short bus, unsigned short address, unsigned int hertz);
+
+/* Set the PWM frequency of the device; the chip is put to sleep while the prescaler is changed. */
+int pcai2c_set_freq(PCA9685Dev *dev, unsigned int hertz);
+
+/* The prescaler value the device uses for the requested frequency. */
+unsigned char pcai2c_prescale(unsigned int hertz);
+
+/* The PWM frame period actually produced for the requested frequency, after prescaler rounding. */
+long long pcai2c_period_ns(unsigned int hertz);
+
+/* Write the off counts of num consecutive channels, starting at first_channel, in a single I2C_RDWR burst. */
+int pcai2c_write(PCA9685Dev *dev, unsigned short first_channel, const unsigned short *counts, unsigned short num);
+
+/* Turn every channel fully off. */
+int pcai2c_reset(PCA9685Dev *dev);
+
+/* Close the device's file descriptor. */
+void pcai2c_close(PCA9685Dev *dev);
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef PRECISION_H_DEF
+#define PRECISION_H_DEF
+
+/*
+ File:          precision.h
+ Description:   Compile-time number format for the animation pipeline; keyframe lanes, the 
+                per-tick kernel, the servo frames and the easing functions.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#include <stdint.h>
+#include <math.h>
+
+#define PRECISION_DOUBLE 0
+#define PRECISION_FLOAT 1
+#define PRECISION_Q16 2
+
+/* Chosen with make PRECISION=DOUBLE, FLOAT or Q16. */
+#ifndef PEABOT_PRECISION
+#define PEABOT_PRECISION PRECISION_DOUBLE
+#endif
+
+#if PEABOT_PRECISION == PRECISION_DOUBLE
+
+typedef double AnimReal;
+
+#define PRECISION_NAME "double"
+#define ANIM_ONE 1.0
+#define ANIM_REAL(x) ((AnimReal) (x))
+#define ANIM_DOUBLE(x) ((double) (x))
+#define ANIM_MUL(a, b) ((a) * (b))
+#define ANIM_TO_Q15(x) ((int) ((x) * 32768.0))
+
+#elif PEABOT_PRECISION == PRECISION_FLOAT
+
+typedef float AnimReal;
+
+#define PRECISION_NAME "float"
+#define ANIM_ONE 1.0f
+#define ANIM_REAL(x) ((AnimReal) (x))
+#define ANIM_DOUBLE(x) ((double) (x))
+#define ANIM_MUL(a, b) ((a) * (b))
+#define ANIM_TO_Q15(x) ((int) ((x) * 32768.0f))
+
+#elif PEABOT_PRECISION == PRECISION_Q16
+
+/* 
+ Signed Q16.16, so values must stay within +-32768. A product goes through 64 bits but is narrowed 
+ back, so the product has to fit as well as each operand; keyframe baking keeps time * scale within 
+ range. Conversions and products saturate rather than wrap if anything else strays outside it. 
+ */
+typedef int32_t AnimReal;
+
+#define PRECISION_NAME "q16"
+#define ANIM_ONE 65536
+#define ANIM_REAL(x) anim_q16_real((double) (x))
+#define ANIM_DOUBLE(x) ((double) (x) / 65536.0)
+#define ANIM_MUL(a, b) anim_q16_mul((a), (b))
+#define ANIM_TO_Q15(x) ((int) ((x) >> 1))
+
+static inline AnimReal anim_q16_real(double x)
+{
+    double q = x * 65536.0;
+    return q >= (double) INT32_MAX ? INT32_MAX : (q <= (double) INT32_MIN ? INT32_MIN : (AnimReal) lround(q));
+}
+
+static inline AnimReal anim_q16_mul(AnimReal a, AnimReal b)
+{
+    int64_t p = ((int64_t) a * (int64_t) b) >> 16;
+    return p > INT32_MAX ? INT32_MAX : (p < INT32_MIN ? INT32_MIN : (AnimReal) p);
+}
+
+#else
+#error "PEABOT_PRECISION must be PRECISION_DOUBLE, PRECISION_FLOAT or PRECISION_Q16."
+#endif
+
+#endif
@@ -38,4 +38,31 @@ void promptcmd_halt(char *args[], int arg_num);
 /* Callback to move the robot laterally. */
 void promptcmd_strafe(char *args[], int arg_num);
 
+/* Callback to steer the oscillator gait with continuous velocities; a halt stops it. */
+void promptcmd_gait(char *args[], int arg_num);
+
+/* Callback to play a motion from the motion library. */
+void promptcmd_motion(char *args[], int arg_num);
+
+/* Callback for reloading the motion library file and listing its motions. */
+void promptcmd_motion_reload(char *args[], int arg_num);
+
+/* Callback for printing the robot's output loop and servo write statistics. */
+void promptcmd_stats(char *args[], int arg_num);
+
+/* Callback for printing the control loop stage latencies, or clearing them with "reset". */
+void promptcmd_timing(char *args[], int arg_num);
+
+/* Callback for checking the keyframe kernel in this build's precision against double, and timing it. */
+void promptcmd_precision_bench(char *args[], int arg_num);
+
+/* Callback for timing the direct and lookup table easing paths, and printing each table's error. */
+void promptcmd_easing_bench(char *args[], int arg_num);
+
+/* Callback for checking the leg IK grid against the direct solution, and timing both. */
+void promptcmd_ik_bench(char *args[], int arg_num);
+
+/* Callback for writing the simulated servo driver's write log to a CSV file. */
+void promptcmd_sim_dump(char *args[], int arg_num);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,50 @@
+#ifndef RING_BUFFER_H_DEF
+#define RING_BUFFER_H_DEF
+
+/*
+ File:          ring_buffer.h
+ Description:   Fixed-capacity, lock-free FIFO ring of pointers for exactly one 
+                producer thread and one consumer thread.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#define RING_BUFFER_LINE 64
+
+/* head is only written by the consumer and tail only by the producer; each sits on its own cache line. */
+typedef struct RingBuffer {
+    void **items;
+    size_t capacity;
+    _Alignas(RING_BUFFER_LINE) atomic_size_t head;
+    _Alignas(RING_BUFFER_LINE) atomic_size_t tail;
+} RingBuffer;
+
+/* Allocate a ring holding up to capacity items; returns 0 or an errno value. */
+int ring_init(RingBuffer *ring, size_t capacity);
+
+/* Free the ring's storage; the items themselves are the caller's. */
+void ring_destroy(RingBuffer *ring);
+
+/* Producer side; append data to the back of the ring, false if the ring is full. */
+bool ring_push(RingBuffer *ring, void *data);
+
+/* Consumer side; remove and return the item at the front of the ring, NULL if it is empty. */
+void *ring_pop(RingBuffer *ring);
+
+/* Consumer side; return the item at the front of the ring without removing it, NULL if it is empty. */
+void *ring_peek(RingBuffer *ring);
+
+/* Consumer side; return the item n places behind the front without removing anything, NULL if there is none. */
+void *ring_peek_at(RingBuffer *ring, size_t n);
+
+/* Get the number of items in the ring; exact from either side, a snapshot from any other thread, never more than capacity. */
+size_t ring_count(RingBuffer *ring);
+
+/* Get the number of items which can still be pushed; never more than the producer can actually push, and never below 0. */
+size_t ring_space(RingBuffer *ring);
+
+#endif
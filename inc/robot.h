@@ -8,11 +8,51 @@
  Author:        Matt Mumau
  */
 
+#include <stdbool.h>
+#include <time.h>
+
+#include "precision.h"
+
+#define ROBOT_JOINT_ONE 32768
+#define ROBOT_JOINT_SHIFT 16
+
 typedef struct ServoLimit {
     unsigned short min;
     unsigned short max;
 } ServoLimit;
 
+/* 
+ A joint's output mapping precompiled from its board, pin, limits and inversion; the PWM count 
+ is (offset + scale * val) >> ROBOT_JOINT_SHIFT, with val in Q15 fixed point. 
+ */
+typedef struct JointMap {
+    unsigned short joint;
+    unsigned short board;
+    unsigned short pin;
+    int offset;
+    int scale;
+} JointMap;
+
+/* Accounting for the robot's output loop deadlines. */
+typedef struct RobotTickStats {
+    unsigned long ticks;
+    unsigned long overruns;
+    unsigned long skipped;
+    unsigned long write_errors;
+} RobotTickStats;
+
+/* Servo output traffic; channel_writes counts channels actually sent, frame_channels what a full write of every tick would have sent. */
+typedef struct RobotWriteStats {
+    unsigned long transfers;
+    unsigned long idle_ticks;
+    unsigned long full_refreshes;
+    unsigned long channel_writes;
+    unsigned long frame_channels;
+} RobotWriteStats;
+
+/* Called on the output thread at every tick with the time its frame is due, just before the frame is picked up. */
+typedef void (*RobotTickHook)(const struct timespec *due);
+
 /* Initialize the robot device and its resources, and begin its loop. */
 void robot_init();
 
@@ -22,10 +62,28 @@ void robot_halt();
 /* Resets the robot to its "home" position */
 void robot_reset();
 
-/* Set the value of the servo at the given pin; will be mapped between -1.0 and 1.0 */
-void robot_setservo(unsigned short pin, double val);
+/* The pending frame of joint values, each between -1.0 and 1.0 in the build's AnimReal; every joint must be written before it is published. */
+AnimReal *robot_frame_begin();
+
+/* Hand the pending frame to the output loop as a whole; never blocks. Only one thread may produce frames at a time. */
+void robot_frame_publish();
+
+/* 
+ Run hook on every output tick, or stop with NULL; once this returns, the previous hook is no longer running. 
+ False, changing nothing, if called from within a hook. 
+ */
+bool robot_set_tick_hook(RobotTickHook hook);
 
-/* Return the current value of a given servo. */
+/* The output loop's tick in nanoseconds; the PWM frame period once robot_pwm_sync has taken effect. */
+long long robot_tick_ns();
+
+/* Return the value of a given servo in the frame the output loop last picked up. */
 double robot_getservo(unsigned short pin);
 
+/* Copy the servo output traffic counters into stats. */
+void robot_get_writestats(RobotWriteStats *stats);
+
+/* Copy the output loop's tick, overrun, skipped deadline and write error counts into stats. */
+void robot_get_tickstats(RobotTickStats *stats);
+
 #endif
\ No newline at end of file
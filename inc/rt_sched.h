@@ -0,0 +1,27 @@
+#ifndef RT_SCHED_H_DEF
+#define RT_SCHED_H_DEF
+
+/*
+ File:          rt_sched.h
+ Description:   Real-time scheduling of Peabot's control threads.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#include <pthread.h>
+
+#define RT_THREAD_ROBOT 0
+#define RT_THREAD_KEYFR 1
+#define RT_THREAD_EVENTS 2
+#define RT_THREAD_NUM 3
+
+/* Apply the configured priority and CPU set to a control thread; does nothing unless rt_enable is set. */
+void rtsched_apply(pthread_t thread, unsigned short rt_thread);
+
+/* Lock the process' current memory into RAM; does nothing unless rt_enable and rt_mlockall are set. */
+void rtsched_lock_memory();
+
+/* Write what was applied to each control thread to the console and the log. */
+void rtsched_report();
+
+#endif
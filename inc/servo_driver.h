@@ -0,0 +1,50 @@
+#ifndef SERVO_DRIVER_H_DEF
+#define SERVO_DRIVER_H_DEF
+
+/*
+ File:          servo_driver.h
+ Description:   Interface for the backends which output servo frames.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#include <stdbool.h>
+#include <time.h>
+
+#define SERVO_DRIVER_PCA9685 0
+#define SERVO_DRIVER_SIM 1
+
+#define SERVO_DRIVER_CHANNELS 16
+
+typedef struct ServoDriver {
+    const char *name;
+
+    /* Open boards_num boards; returns 0 or an error code. */
+    int (*init)(unsigned short boards_num);
+
+    /* 
+     Output the channels set in dirty_mask from a frame of SERVO_DRIVER_CHANNELS counts to one board; 
+     returns the number of channels sent, or a negative error. Different boards may be written concurrently.
+     */
+    int (*write)(unsigned short board, const unsigned short *frame, unsigned int dirty_mask);
+
+    /* Get the nominal PWM frame period and a CLOCK_MONOTONIC time a frame of board 0 started; returns 0, or an error if unknown. */
+    int (*frame_timing)(long long *period_ns, struct timespec *frame_start);
+
+    /* Turn every channel of every board off. */
+    void (*reset)();
+
+    /* Close the backend and release its resources. */
+    void (*halt)();
+} ServoDriver;
+
+/* Get the driver for the given SERVO_DRIVER_* type; NULL if there is no such type. */
+ServoDriver *srvdrv_get(unsigned short driver_type);
+
+/* Get the SERVO_DRIVER_* type from its config name. */
+unsigned short srvdrv_str_to_type(const char *str);
+
+/* Get the config name of a SERVO_DRIVER_* type. */
+const char *srvdrv_type_to_str(unsigned short driver_type);
+
+#endif
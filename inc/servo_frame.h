@@ -0,0 +1,43 @@
+#ifndef SERVO_FRAME_H_DEF
+#define SERVO_FRAME_H_DEF
+
+/*
+ File:          servo_frame.h
+ Description:   Lock-free triple buffer handing whole servo frames from a single 
+                producer thread to a single consumer thread.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#include <stdatomic.h>
+
+#include "precision.h"
+
+#define SERVO_FRAME_BUFFERS 3
+#define SERVO_FRAME_FRESH 0x4U
+#define SERVO_FRAME_INDEX 0x3U
+
+typedef struct ServoFrame {
+    AnimReal *buffer[SERVO_FRAME_BUFFERS];
+    size_t len;
+    unsigned int back;
+    unsigned int front;
+    atomic_uint latest;
+} ServoFrame;
+
+/* Allocate three zeroed buffers of len positions; returns 0 or an errno value. */
+int srvframe_init(ServoFrame *frame, size_t len);
+
+/* Free the buffers of the frame. */
+void srvframe_destroy(ServoFrame *frame);
+
+/* Producer side; the buffer to fill with the next complete frame. Its previous contents are stale. */
+AnimReal *srvframe_back(ServoFrame *frame);
+
+/* Producer side; publish the back buffer as the latest frame without ever blocking. */
+void srvframe_publish(ServoFrame *frame);
+
+/* Consumer side; the most recently published frame, or the one returned last time if nothing new was published. */
+const AnimReal *srvframe_acquire(ServoFrame *frame);
+
+#endif
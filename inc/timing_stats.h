@@ -0,0 +1,59 @@
+#ifndef TIMING_STATS_H_DEF
+#define TIMING_STATS_H_DEF
+
+/*
+ File:          timing_stats.h
+ Description:   Lock-free log-linear latency histograms for the control loop stages.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#include <stdatomic.h>
+
+#define TMSTATS_ROBOT_LATENESS 0
+#define TMSTATS_ROBOT_TICK 1
+#define TMSTATS_ROBOT_MAP 2
+#define TMSTATS_ROBOT_WRITE 3
+#define TMSTATS_KEYFR_EVAL 4
+#define TMSTATS_KEYFR_LATENESS 5
+#define TMSTATS_NUM 6
+
+/* Each power of two is split into 2^TMSTATS_SUB_BITS buckets, so values are kept to within ~6%. */
+#define TMSTATS_SUB_BITS 4
+#define TMSTATS_SUB_BUCKETS (1 << TMSTATS_SUB_BITS)
+#define TMSTATS_MAX_BITS 40
+#define TMSTATS_BUCKETS ((TMSTATS_MAX_BITS - TMSTATS_SUB_BITS + 2) * TMSTATS_SUB_BUCKETS)
+
+/* The totals are 64 bits even where long is 32; a 32 bit sum of nanoseconds wraps after 4.3 s. */
+typedef struct TimingHist {
+    atomic_ullong count;
+    atomic_ullong sum;
+    atomic_ullong max;
+    atomic_ulong buckets[TMSTATS_BUCKETS];
+} TimingHist;
+
+/* A histogram's figures in microseconds; percentiles are bucket midpoints. */
+typedef struct TimingSummary {
+    unsigned long long count;
+    double mean;
+    double p50;
+    double p99;
+    double max;
+} TimingSummary;
+
+/* The current CLOCK_MONOTONIC time in nanoseconds. */
+long long tmstats_now();
+
+/* Add one sample, in nanoseconds, to the given TMSTATS_* stage; safe from any thread and never blocks. */
+void tmstats_record(unsigned short stage, long long nsec);
+
+/* Summarize the given stage into summary. */
+void tmstats_get(unsigned short stage, TimingSummary *summary);
+
+/* Clear every stage's histogram. */
+void tmstats_reset();
+
+/* Get the name of a TMSTATS_* stage. */
+const char *tmstats_stage_name(unsigned short stage);
+
+#endif
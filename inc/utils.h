@@ -23,4 +23,10 @@ double utils_timediff(struct timespec end_time, struct timespec start_time);
 
 double utils_timespec_to_secs(struct timespec ts);
 
+/* Advance the timespec by the given number of nanoseconds, keeping tv_nsec normalized. */
+void utils_timespec_addns(struct timespec *ts, long long nsec);
+
+/* Get the difference in nanoseconds between the timespecs. */
+long long utils_timediff_ns(struct timespec end_time, struct timespec start_time);
+
 #endif
\ No newline at end of file
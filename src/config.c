@@ -15,6 +15,7 @@
 #include <stdlib.h>
 #include <time.h>
 #include <string.h>
+#include <stdatomic.h>
 
 /* Application includes */
 #include "main.h"
@@ -24,6 +25,7 @@
 #include "configset_callbacks.h"
 #include "config_stdin.h"
 #include "config_file.h"
+#include "servo_driver.h"
 
 /* Header */
 #include "config.h"
@@ -31,10 +33,12 @@
 /* Forward decs */
 static void config_set_defaults();
 static char *config_default_log_filename();
+static void config_default_joints();
 static void config_default_servo_pin_data();
 static void config_default_servo_limit_data();
 
 static Config config;
+static atomic_uint config_version = 0;
 
 void config_init(int argc, char *argv[])
 {
@@ -55,11 +59,11 @@ void config_destroy()
     if (config.log_fullpath)
         free((char *) config.log_fullpath);
 
-    if (config.servo_pins)
-        free(config.servo_pins);
+    if (config.joints)
+        free(config.joints);
 
-    if (config.servo_limits)
-        free(config.servo_limits);
+    if (config.pca_9685_boards)
+        free(config.pca_9685_boards);
 }
 
 void config_set(unsigned short config_var, void *data, bool is_string)
@@ -100,24 +104,114 @@ void config_set(unsigned short config_var, void *data, bool is_string)
     if (config_var == CONF_PCA_9685_HERTZ) 
         config_set_callback = configset_pca_9685_hertz;           
 
+    if (config_var == CONF_PCA_9685_BURST)
+        config_set_callback = configset_pca_9685_burst;
+
+    if (config_var == CONF_PCA_9685_I2C_BUS)
+        config_set_callback = configset_pca_9685_i2c_bus;
+
+    if (config_var == CONF_PCA_9685_ADDRESS)
+        config_set_callback = configset_pca_9685_address;
+
+    if (config_var == CONF_PCA_9685_LIMITS_HERTZ)
+        config_set_callback = configset_pca_9685_limits_hertz;
+
+    if (config_var == CONF_SERVO_DRIVER)
+        config_set_callback = configset_servo_driver;
+
     if (config_var == CONF_SERVOS_NUM) 
         config_set_callback = configset_servos_num;       
 
     if (config_var == CONF_ROBOT_TICK) 
         config_set_callback = configset_robot_tick;      
 
+    if (config_var == CONF_ROBOT_REFRESH_TICKS)
+        config_set_callback = configset_robot_refresh_ticks;
+
+    if (config_var == CONF_ROBOT_PWM_SYNC)
+        config_set_callback = configset_robot_pwm_sync;
+
+    if (config_var == CONF_ROBOT_PWM_LEAD)
+        config_set_callback = configset_robot_pwm_lead;
+
+    if (config_var == CONF_ROBOT_UNIFIED_LOOP)
+        config_set_callback = configset_robot_unified_loop;
+
     if (config_var == CONF_TRANSITIONS_ENABLE) 
         config_set_callback = configset_transitions_enable;    
 
     if (config_var == CONF_TRANSITIONS_TIME) 
         config_set_callback = configset_transition_time;       
 
+    if (config_var == CONF_KEYFRAME_QUEUE_SIZE)
+        config_set_callback = configset_keyframe_queue_size;
+
+    if (config_var == CONF_EASING_LUT)
+        config_set_callback = configset_easing_lut;
+
+    if (config_var == CONF_KEYFRAME_SPLINE)
+        config_set_callback = configset_keyframe_spline;
+
+    if (config_var == CONF_BLEND_TIME)
+        config_set_callback = configset_blend_time;
+
+    if (config_var == CONF_CPG_FREQUENCY)
+        config_set_callback = configset_cpg_frequency;
+
+    if (config_var == CONF_CPG_SMOOTHING)
+        config_set_callback = configset_cpg_smoothing;
+
+    if (config_var == CONF_LEG_FEMUR_LENGTH)
+        config_set_callback = configset_leg_femur_length;
+
+    if (config_var == CONF_LEG_TIBIA_LENGTH)
+        config_set_callback = configset_leg_tibia_length;
+
+    if (config_var == CONF_LEG_JOINT_RANGE)
+        config_set_callback = configset_leg_joint_range;
+
+    if (config_var == CONF_LEG_KNEE_ZERO)
+        config_set_callback = configset_leg_knee_zero;
+
+    if (config_var == CONF_MOTION_LIBRARY)
+        config_set_callback = configset_motion_library;
+
     if (config_var == CONF_SERVO_PINS) 
         config_set_callback = configset_servo_pins;  
 
     if (config_var == CONF_SERVO_LIMITS) 
         config_set_callback = configset_servo_limits;    
 
+    if (config_var == CONF_JOINTS)
+        config_set_callback = configset_joints;
+
+    if (config_var == CONF_PCA_9685_BOARDS)
+        config_set_callback = configset_pca_9685_boards;
+
+    if (config_var == CONF_RT_ENABLE)
+        config_set_callback = configset_rt_enable;
+
+    if (config_var == CONF_RT_MLOCKALL)
+        config_set_callback = configset_rt_mlockall;
+
+    if (config_var == CONF_RT_ROBOT_PRIORITY)
+        config_set_callback = configset_rt_robot_priority;
+
+    if (config_var == CONF_RT_ROBOT_CPUS)
+        config_set_callback = configset_rt_robot_cpus;
+
+    if (config_var == CONF_RT_KEYFR_PRIORITY)
+        config_set_callback = configset_rt_keyfr_priority;
+
+    if (config_var == CONF_RT_KEYFR_CPUS)
+        config_set_callback = configset_rt_keyfr_cpus;
+
+    if (config_var == CONF_RT_EVENTS_PRIORITY)
+        config_set_callback = configset_rt_events_priority;
+
+    if (config_var == CONF_RT_EVENTS_CPUS)
+        config_set_callback = configset_rt_events_cpus;
+
     if (config_var == CONF_WALK_HIP_DELTA) 
         config_set_callback = configset_walk_hip_delta;         
 
@@ -138,11 +232,19 @@ void config_set(unsigned short config_var, void *data, bool is_string)
 
     /* Callback execute */
     if (config_set_callback != NULL)
+    {
         (*config_set_callback)(&config, data, is_string);
+        atomic_fetch_add_explicit(&config_version, 1, memory_order_release);
+    }
 
     return;
 }
 
+unsigned int config_get_version()
+{
+    return atomic_load_explicit(&config_version, memory_order_acquire);
+}
+
 void *config_get(unsigned short config_var)
 {
     void *ret_val = NULL;
@@ -183,11 +285,38 @@ void *config_get(unsigned short config_var)
      if (config_var == CONF_PCA_9685_HERTZ)
         ret_val = (void *) &(config.pca_9685_hertz);
 
+     if (config_var == CONF_PCA_9685_BURST)
+        ret_val = (void *) &(config.pca_9685_burst);
+
+     if (config_var == CONF_PCA_9685_I2C_BUS)
+        ret_val = (void *) &(config.pca_9685_i2c_bus);
+
+     if (config_var == CONF_PCA_9685_ADDRESS)
+        ret_val = (void *) &(config.pca_9685_address);
+
+     if (config_var == CONF_PCA_9685_LIMITS_HERTZ)
+        ret_val = (void *) &(config.pca_9685_limits_hertz);
+
+     if (config_var == CONF_SERVO_DRIVER)
+        ret_val = (void *) &(config.servo_driver);
+
      if (config_var == CONF_SERVOS_NUM)
         ret_val = (void *) &(config.servos_num);
 
      if (config_var == CONF_ROBOT_TICK)
         ret_val = (void *) &(config.robot_tick);   
+
+     if (config_var == CONF_ROBOT_REFRESH_TICKS)
+        ret_val = (void *) &(config.robot_refresh_ticks);
+
+     if (config_var == CONF_ROBOT_PWM_SYNC)
+        ret_val = (void *) &(config.robot_pwm_sync);
+
+     if (config_var == CONF_ROBOT_PWM_LEAD)
+        ret_val = (void *) &(config.robot_pwm_lead);
+
+     if (config_var == CONF_ROBOT_UNIFIED_LOOP)
+        ret_val = (void *) &(config.robot_unified_loop);
         
      if (config_var == CONF_TRANSITIONS_ENABLE)
         ret_val = (void *) &(config.transitions_enable);  
@@ -195,15 +324,72 @@ void *config_get(unsigned short config_var)
      if (config_var == CONF_TRANSITIONS_TIME)
         ret_val = (void *) &(config.transition_time);                
 
+     if (config_var == CONF_KEYFRAME_QUEUE_SIZE)
+        ret_val = (void *) &(config.keyframe_queue_size);
+
+     if (config_var == CONF_EASING_LUT)
+        ret_val = (void *) &(config.easing_lut);
+
+     if (config_var == CONF_KEYFRAME_SPLINE)
+        ret_val = (void *) &(config.keyframe_spline);
+
+     if (config_var == CONF_BLEND_TIME)
+        ret_val = (void *) &(config.blend_time);
+
+     if (config_var == CONF_CPG_FREQUENCY)
+        ret_val = (void *) &(config.cpg_frequency);
+
+     if (config_var == CONF_CPG_SMOOTHING)
+        ret_val = (void *) &(config.cpg_smoothing);
+
+     if (config_var == CONF_LEG_FEMUR_LENGTH)
+        ret_val = (void *) &(config.leg_femur_length);
+
+     if (config_var == CONF_LEG_TIBIA_LENGTH)
+        ret_val = (void *) &(config.leg_tibia_length);
+
+     if (config_var == CONF_LEG_JOINT_RANGE)
+        ret_val = (void *) &(config.leg_joint_range);
+
+     if (config_var == CONF_LEG_KNEE_ZERO)
+        ret_val = (void *) &(config.leg_knee_zero);
+
+     if (config_var == CONF_MOTION_LIBRARY)
+        ret_val = (void *) config.motion_library;
+
      if (config_var == CONF_TRANSITIONS_TIME)
         ret_val = (void *) &(config.transition_time); 
 
-     if (config_var == CONF_SERVO_PINS)
-        ret_val = (void *) config.servo_pins;       
-        
-     if (config_var == CONF_SERVO_LIMITS)
-        ret_val = (void *) config.servo_limits;   
+     if (config_var == CONF_JOINTS)
+        ret_val = (void *) config.joints;
+
+     if (config_var == CONF_PCA_9685_BOARDS)
+        ret_val = (void *) config.pca_9685_boards;
         
+     if (config_var == CONF_RT_ENABLE)
+        ret_val = (void *) &(config.rt_enable);
+
+     if (config_var == CONF_RT_MLOCKALL)
+        ret_val = (void *) &(config.rt_mlockall);
+
+     if (config_var == CONF_RT_ROBOT_PRIORITY)
+        ret_val = (void *) &(config.rt_robot_priority);
+
+     if (config_var == CONF_RT_ROBOT_CPUS)
+        ret_val = (void *) &(config.rt_robot_cpus);
+
+     if (config_var == CONF_RT_KEYFR_PRIORITY)
+        ret_val = (void *) &(config.rt_keyfr_priority);
+
+     if (config_var == CONF_RT_KEYFR_CPUS)
+        ret_val = (void *) &(config.rt_keyfr_cpus);
+
+     if (config_var == CONF_RT_EVENTS_PRIORITY)
+        ret_val = (void *) &(config.rt_events_priority);
+
+     if (config_var == CONF_RT_EVENTS_CPUS)
+        ret_val = (void *) &(config.rt_events_cpus);
+
      if (config_var == CONF_WALK_HIP_DELTA)
         ret_val = (void *) &(config.walk_hip_delta);
 
@@ -227,35 +413,26 @@ void *config_get(unsigned short config_var)
 
 unsigned short config_str_to_servo_index(const char *str)
 {
-    if (str_starts(str, "back_left_knee"))
-        return SERVO_INDEX_BACK_LEFT_KNEE;
-
-    if (str_starts(str, "back_left_hip"))
-        return SERVO_INDEX_BACK_LEFT_HIP; 
-
-    if (str_starts(str, "front_left_knee"))
-        return SERVO_INDEX_FRONT_LEFT_KNEE;  
-
-    if (str_starts(str, "front_left_hip"))
-        return SERVO_INDEX_FRONT_LEFT_HIP;
-
-    if (str_starts(str, "back_right_knee"))
-        return SERVO_INDEX_BACK_RIGHT_KNEE;
-
-    if (str_starts(str, "back_right_hip"))
-        return SERVO_INDEX_BACK_RIGHT_HIP; 
-
-    if (str_starts(str, "front_right_knee"))
-        return SERVO_INDEX_FRONT_RIGHT_KNEE;  
-
-    if (str_starts(str, "front_right_hip"))
-        return SERVO_INDEX_FRONT_RIGHT_HIP;        
+    for (unsigned short i = 0; i < config.servos_num; i++)
+    {
+        if (str_equals(config.joints[i].name, str))
+            return i;
+    }
 
     return -1;                        
 }
 
 static void config_set_defaults()
 {
+    // Allocated up front; the servos_num and joint setters index into these.
+    config.joints = calloc(DEFAULT_JOINTS_MAX, sizeof(JointDesc));
+    if (!config.joints)
+        APP_ERROR("Unable to allocate memory.", 1);
+
+    config.pca_9685_boards = calloc(DEFAULT_PCA_9685_BOARDS_MAX, sizeof(PCA9685Board));
+    if (!config.pca_9685_boards)
+        APP_ERROR("Unable to allocate memory.", 1);
+
     const char *log_file_dir = DEFAULT_LOG_DIR;
     config_set(CONF_LOG_FILE_DIR, (void *) log_file_dir, false);
     
@@ -296,18 +473,102 @@ static void config_set_defaults()
     unsigned int pca_9685_hertz = DEFAULT_PCA_9685_HERTZ;
     config_set(CONF_PCA_9685_HERTZ, (void *) &pca_9685_hertz, false);
 
+    bool pca_9685_burst = DEFAULT_PCA_9685_BURST;
+    config_set(CONF_PCA_9685_BURST, (void *) &pca_9685_burst, false);
+
+    unsigned short pca_9685_i2c_bus = DEFAULT_PCA_9685_I2C_BUS;
+    config_set(CONF_PCA_9685_I2C_BUS, (void *) &pca_9685_i2c_bus, false);
+
+    unsigned short pca_9685_address = DEFAULT_PCA_9685_ADDRESS;
+    config_set(CONF_PCA_9685_ADDRESS, (void *) &pca_9685_address, false);
+
+    unsigned int pca_9685_limits_hertz = DEFAULT_PCA_9685_LIMITS_HERTZ;
+    config_set(CONF_PCA_9685_LIMITS_HERTZ, (void *) &pca_9685_limits_hertz, false);
+
+    unsigned short servo_driver = DEFAULT_SERVO_DRIVER;
+    config_set(CONF_SERVO_DRIVER, (void *) &servo_driver, false);
+
     unsigned short servos_num = DEFAULT_SERVOS_NUM;
     config_set(CONF_SERVOS_NUM, (void *) &servos_num, false);
 
     double robot_tick = DEFAULT_ROBOT_TICK;
     config_set(CONF_ROBOT_TICK, (void *) &robot_tick, false);
 
+    unsigned short robot_refresh_ticks = DEFAULT_ROBOT_REFRESH_TICKS;
+    config_set(CONF_ROBOT_REFRESH_TICKS, (void *) &robot_refresh_ticks, false);
+
+    bool robot_pwm_sync = DEFAULT_ROBOT_PWM_SYNC;
+    config_set(CONF_ROBOT_PWM_SYNC, (void *) &robot_pwm_sync, false);
+
+    double robot_pwm_lead = DEFAULT_ROBOT_PWM_LEAD;
+    config_set(CONF_ROBOT_PWM_LEAD, (void *) &robot_pwm_lead, false);
+
+    bool robot_unified_loop = DEFAULT_ROBOT_UNIFIED_LOOP;
+    config_set(CONF_ROBOT_UNIFIED_LOOP, (void *) &robot_unified_loop, false);
+
     bool transitions_enable = DEFAULT_TRANSITIONS_ENABLE;
     config_set(CONF_TRANSITIONS_ENABLE, (void *) &transitions_enable, false);
 
     double transitions_time = DEFAULT_KEYFRAME_TRANSITION_TIME;
     config_set(CONF_TRANSITIONS_TIME, (void *) &transitions_time, false);
 
+    unsigned int keyframe_queue_size = DEFAULT_KEYFRAME_QUEUE_SIZE;
+    config_set(CONF_KEYFRAME_QUEUE_SIZE, (void *) &keyframe_queue_size, false);
+
+    bool easing_lut = DEFAULT_EASING_LUT;
+    config_set(CONF_EASING_LUT, (void *) &easing_lut, false);
+
+    bool keyframe_spline = DEFAULT_KEYFRAME_SPLINE;
+    config_set(CONF_KEYFRAME_SPLINE, (void *) &keyframe_spline, false);
+
+    double blend_time = DEFAULT_BLEND_TIME;
+    config_set(CONF_BLEND_TIME, (void *) &blend_time, false);
+
+    double cpg_frequency = DEFAULT_CPG_FREQUENCY;
+    config_set(CONF_CPG_FREQUENCY, (void *) &cpg_frequency, false);
+
+    double cpg_smoothing = DEFAULT_CPG_SMOOTHING;
+    config_set(CONF_CPG_SMOOTHING, (void *) &cpg_smoothing, false);
+
+    double leg_femur_length = DEFAULT_LEG_FEMUR_LENGTH;
+    config_set(CONF_LEG_FEMUR_LENGTH, (void *) &leg_femur_length, false);
+
+    double leg_tibia_length = DEFAULT_LEG_TIBIA_LENGTH;
+    config_set(CONF_LEG_TIBIA_LENGTH, (void *) &leg_tibia_length, false);
+
+    double leg_joint_range = DEFAULT_LEG_JOINT_RANGE;
+    config_set(CONF_LEG_JOINT_RANGE, (void *) &leg_joint_range, false);
+
+    double leg_knee_zero = DEFAULT_LEG_KNEE_ZERO;
+    config_set(CONF_LEG_KNEE_ZERO, (void *) &leg_knee_zero, false);
+
+    const char *motion_library = DEFAULT_MOTION_LIBRARY;
+    config_set(CONF_MOTION_LIBRARY, (void *) motion_library, false);
+
+    bool rt_enable = DEFAULT_RT_ENABLE;
+    config_set(CONF_RT_ENABLE, (void *) &rt_enable, false);
+
+    bool rt_mlockall = DEFAULT_RT_MLOCKALL;
+    config_set(CONF_RT_MLOCKALL, (void *) &rt_mlockall, false);
+
+    unsigned short rt_robot_priority = DEFAULT_RT_ROBOT_PRIORITY;
+    config_set(CONF_RT_ROBOT_PRIORITY, (void *) &rt_robot_priority, false);
+
+    unsigned int rt_robot_cpus = DEFAULT_RT_ROBOT_CPUS;
+    config_set(CONF_RT_ROBOT_CPUS, (void *) &rt_robot_cpus, false);
+
+    unsigned short rt_keyfr_priority = DEFAULT_RT_KEYFR_PRIORITY;
+    config_set(CONF_RT_KEYFR_PRIORITY, (void *) &rt_keyfr_priority, false);
+
+    unsigned int rt_keyfr_cpus = DEFAULT_RT_KEYFR_CPUS;
+    config_set(CONF_RT_KEYFR_CPUS, (void *) &rt_keyfr_cpus, false);
+
+    unsigned short rt_events_priority = DEFAULT_RT_EVENTS_PRIORITY;
+    config_set(CONF_RT_EVENTS_PRIORITY, (void *) &rt_events_priority, false);
+
+    unsigned int rt_events_cpus = DEFAULT_RT_EVENTS_CPUS;
+    config_set(CONF_RT_EVENTS_CPUS, (void *) &rt_events_cpus, false);
+
     double walk_hip_delta = DEFAULT_HIP_DELTA;
     config_set(CONF_WALK_HIP_DELTA, (void *) &walk_hip_delta, false);
 
@@ -327,18 +588,45 @@ static void config_set_defaults()
     config_set(CONF_HTTP_PORT, (void *) &http_port, false);
 
     // Do these after processing other configs; dependent upon them.
-    config.servo_pins = calloc(config.servos_num, sizeof(unsigned short));
-    if (!config.servo_pins)
-        APP_ERROR("Unable to allocate memory.", 1);
-
+    config_default_joints();
     config_default_servo_pin_data();
-
-    config.servo_limits = calloc(config.servos_num, sizeof(ServoLimit));
-    if (!config.servo_pins)
-        APP_ERROR("Unable to allocate memory.", 1);
     config_default_servo_limit_data();
 }
 
+/*
+ Every joint slot gets a placeholder name and consecutive channels across boards, so 
+ raising servos_num alone still gives usable joints; the first eight are the quadruped's.
+ */
+static void config_default_joints()
+{
+    const char *names[] = DEFAULT_JOINT_NAMES;
+    const char *tags[] = DEFAULT_JOINT_TAGS;
+    unsigned short named = sizeof(names) / sizeof(names[0]);
+
+    JointDesc *joint;
+
+    for (unsigned short i = 0; i < DEFAULT_JOINTS_MAX; i++)
+    {
+        joint = &(config.joints[i]);
+        joint->board = i / SERVO_DRIVER_CHANNELS;
+        joint->channel = i % SERVO_DRIVER_CHANNELS;
+        joint->inverted = false;
+
+        if (i < named)
+        {
+            snprintf(joint->name, JOINT_NAME_MAXLEN, "%s", names[i]);
+            snprintf(joint->tags, JOINT_TAGS_MAXLEN, "%s", tags[i]);
+        }
+        else
+            snprintf(joint->name, JOINT_NAME_MAXLEN, "joint_%d", i);
+    }
+
+    config.joints[SERVO_INDEX_FRONT_LEFT_KNEE].inverted = true;
+    config.joints[SERVO_INDEX_FRONT_LEFT_HIP].inverted = true;
+    config.joints[SERVO_INDEX_BACK_RIGHT_KNEE].inverted = true;
+    config.joints[SERVO_INDEX_BACK_RIGHT_HIP].inverted = true;
+}
+
 static void config_default_servo_pin_data()
 {
     ServoPinData servo_pin_data;
@@ -386,7 +674,7 @@ static void config_default_servo_limit_data()
 {    
     ServoLimitData servo_limit_data;
 
-    for (unsigned short j = 0; j < config.servos_num; j++)
+    for (unsigned short j = 0; j < DEFAULT_JOINTS_MAX; j++)
     {
         servo_limit_data.id = j;
         servo_limit_data.min = DEFAULT_SERVO_MIN;
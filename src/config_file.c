@@ -12,6 +12,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
 
 /* Application includes */
 #include "main.h"
@@ -24,6 +25,7 @@
 /* Forward decs */
 static void configfile_parse(FILE *config_file);
 static void configfile_handle_line(char *arg, char *val);
+static void configfile_handle_joint_line(char *arg, char *val);
 
 void configfile_process(char *config_file_fullpath)
 {
@@ -94,18 +96,102 @@ static void configfile_handle_line(char *arg, char *val)
     if (str_equals(arg, "pca_9685_hertz"))
         config_set(CONF_PCA_9685_HERTZ, (void *) val, true);
 
+    if (str_equals(arg, "pca_9685_burst"))
+        config_set(CONF_PCA_9685_BURST, (void *) val, true);
+
+    if (str_equals(arg, "pca_9685_i2c_bus"))
+        config_set(CONF_PCA_9685_I2C_BUS, (void *) val, true);
+
+    if (str_equals(arg, "pca_9685_address"))
+        config_set(CONF_PCA_9685_ADDRESS, (void *) val, true);
+
+    if (str_equals(arg, "pca_9685_limits_hertz"))
+        config_set(CONF_PCA_9685_LIMITS_HERTZ, (void *) val, true);
+
+    if (str_equals(arg, "servo_driver"))
+        config_set(CONF_SERVO_DRIVER, (void *) val, true);
+
     if (str_equals(arg, "servos_num"))
         config_set(CONF_SERVOS_NUM, (void *) val, true);                      
 
     if (str_equals(arg, "robot_tick"))
         config_set(CONF_ROBOT_TICK, (void *) val, true);
 
+    if (str_equals(arg, "robot_refresh_ticks"))
+        config_set(CONF_ROBOT_REFRESH_TICKS, (void *) val, true);
+
+    if (str_equals(arg, "robot_pwm_sync"))
+        config_set(CONF_ROBOT_PWM_SYNC, (void *) val, true);
+
+    if (str_equals(arg, "robot_pwm_lead"))
+        config_set(CONF_ROBOT_PWM_LEAD, (void *) val, true);
+
+    if (str_equals(arg, "robot_unified_loop"))
+        config_set(CONF_ROBOT_UNIFIED_LOOP, (void *) val, true);
+
     if (str_equals(arg, "transitions_enable"))
         config_set(CONF_TRANSITIONS_ENABLE, (void *) val, true);
 
     if (str_equals(arg, "transition_time"))
         config_set(CONF_TRANSITIONS_TIME, (void *) val, true);
 
+    if (str_equals(arg, "keyframe_queue_size"))
+        config_set(CONF_KEYFRAME_QUEUE_SIZE, (void *) val, true);
+
+    if (str_equals(arg, "easing_lut"))
+        config_set(CONF_EASING_LUT, (void *) val, true);
+
+    if (str_equals(arg, "keyframe_spline"))
+        config_set(CONF_KEYFRAME_SPLINE, (void *) val, true);
+
+    if (str_equals(arg, "blend_time"))
+        config_set(CONF_BLEND_TIME, (void *) val, true);
+
+    if (str_equals(arg, "cpg_frequency"))
+        config_set(CONF_CPG_FREQUENCY, (void *) val, true);
+
+    if (str_equals(arg, "cpg_smoothing"))
+        config_set(CONF_CPG_SMOOTHING, (void *) val, true);
+
+    if (str_equals(arg, "leg_femur_length"))
+        config_set(CONF_LEG_FEMUR_LENGTH, (void *) val, true);
+
+    if (str_equals(arg, "leg_tibia_length"))
+        config_set(CONF_LEG_TIBIA_LENGTH, (void *) val, true);
+
+    if (str_equals(arg, "leg_joint_range"))
+        config_set(CONF_LEG_JOINT_RANGE, (void *) val, true);
+
+    if (str_equals(arg, "leg_knee_zero"))
+        config_set(CONF_LEG_KNEE_ZERO, (void *) val, true);
+
+    if (str_equals(arg, "motion_library"))
+        config_set(CONF_MOTION_LIBRARY, (void *) val, true);
+
+    if (str_equals(arg, "rt_enable"))
+        config_set(CONF_RT_ENABLE, (void *) val, true);
+
+    if (str_equals(arg, "rt_mlockall"))
+        config_set(CONF_RT_MLOCKALL, (void *) val, true);
+
+    if (str_equals(arg, "rt_robot_priority"))
+        config_set(CONF_RT_ROBOT_PRIORITY, (void *) val, true);
+
+    if (str_equals(arg, "rt_robot_cpus"))
+        config_set(CONF_RT_ROBOT_CPUS, (void *) val, true);
+
+    if (str_equals(arg, "rt_keyfr_priority"))
+        config_set(CONF_RT_KEYFR_PRIORITY, (void *) val, true);
+
+    if (str_equals(arg, "rt_keyfr_cpus"))
+        config_set(CONF_RT_KEYFR_CPUS, (void *) val, true);
+
+    if (str_equals(arg, "rt_events_priority"))
+        config_set(CONF_RT_EVENTS_PRIORITY, (void *) val, true);
+
+    if (str_equals(arg, "rt_events_cpus"))
+        config_set(CONF_RT_EVENTS_CPUS, (void *) val, true);
+
     if (str_equals(arg, "walk_hip_delta"))
         config_set(CONF_WALK_HIP_DELTA, (void *) val, true);
 
@@ -124,43 +210,60 @@ static void configfile_handle_line(char *arg, char *val)
     if (str_equals(arg, "http_port"))
         config_set(CONF_HTTP_PORT, (void *) val, true);
 
-    if (str_equals(arg, "back_left_knee") ||
-        str_equals(arg, "back_left_hip") ||
-        str_equals(arg, "front_left_knee") ||
-        str_equals(arg, "front_left_hip") ||
-        str_equals(arg, "back_right_knee") ||
-        str_equals(arg, "back_right_hip") ||
-        str_equals(arg, "front_right_knee") ||
-        str_equals(arg, "front_right_hip")
-        )
+    if (str_equals(arg, "pca_9685_board"))
+        config_set(CONF_PCA_9685_BOARDS, (void *) val, true);
+
+    if (str_equals(arg, "joint"))
+        config_set(CONF_JOINTS, (void *) val, true);
+
+    configfile_handle_joint_line(arg, val);
+}
+
+/*
+ The legacy "<joint name> <pin>" and "<joint name>_limits <min>-<max>" lines, for 
+ any joint known at this point in the file.
+ */
+static void configfile_handle_joint_line(char *arg, char *val)
+{
+    if (!val)
+        return;
+
+    char name[JOINT_NAME_MAXLEN];
+    size_t arg_len = strlen(arg);
+    size_t suffix_len = strlen(CONFIG_FILE_LIMITS_SUFFIX);
+
+    bool is_limits = arg_len > suffix_len && str_equals(&arg[arg_len - suffix_len], CONFIG_FILE_LIMITS_SUFFIX);
+    if (is_limits)
+        arg_len -= suffix_len;
+
+    if (arg_len >= JOINT_NAME_MAXLEN)
+        return;
+
+    memcpy(name, arg, arg_len);
+    name[arg_len] = '\0';
+
+    unsigned short servo_index = config_str_to_servo_index(name);
+    if (servo_index == (unsigned short) -1)
+        return;
+
+    if (!is_limits)
     {
-        int servo_index = config_str_to_servo_index(arg);
         int servo_val = (int) atoi(val);
         ServoPinData servo_pin_data = (ServoPinData) { servo_index, servo_val };
         config_set(CONF_SERVO_PINS, (void *) &servo_pin_data, false);
+        return;
     }
 
-    if (str_equals(arg, "back_left_knee_limits") ||
-        str_equals(arg, "back_left_hip_limits") ||
-        str_equals(arg, "front_left_knee_limits") ||
-        str_equals(arg, "front_left_hip_limits") ||
-        str_equals(arg, "back_right_knee_limits") ||
-        str_equals(arg, "back_right_hip_limits") ||
-        str_equals(arg, "front_right_knee_limits") ||
-        str_equals(arg, "front_right_hip_limits")
-        )
-    {    
-        int servo_index = config_str_to_servo_index(arg);
-
-        char *min_tok = strtok(val, "-");
-        char *max_tok = strtok(NULL, "-");
-
-        int min = (int) atoi(min_tok);
-        int max = (int) atoi(max_tok);
-
-        ServoLimitData servo_limit_data = (ServoLimitData) { servo_index, min, max };
-        config_set(CONF_SERVO_LIMITS, (void *) &servo_limit_data, false);
-    }  
+    char *min_tok = strtok(val, "-");
+    char *max_tok = strtok(NULL, "-");
+    if (!min_tok || !max_tok)
+        return;
+
+    int min = (int) atoi(min_tok);
+    int max = (int) atoi(max_tok);
+
+    ServoLimitData servo_limit_data = (ServoLimitData) { servo_index, min, max };
+    config_set(CONF_SERVO_LIMITS, (void *) &servo_limit_data, false);
 }
 
 #endif
\ No newline at end of file
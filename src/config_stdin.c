@@ -96,6 +96,12 @@ static void config_handle_arg(char *arg, char *val)
     if (str_equals(arg, "--transitions-time"))
         config_set(CONF_TRANSITIONS_TIME, (void *) val, true);
 
+    if (str_equals(arg, "--rt-enable"))
+        config_set(CONF_RT_ENABLE, (void *) val, true);
+
+    if (str_equals(arg, "--rt-mlockall"))
+        config_set(CONF_RT_MLOCKALL, (void *) val, true);
+
     if (str_equals(arg, "--walk-hip-delta"))
         config_set(CONF_WALK_HIP_DELTA, (void *) val, true);
 
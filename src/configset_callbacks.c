@@ -10,16 +10,26 @@
 
 /* System includes */
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 /* Application includes */
+#include "main.h"
 #include "config.h"
+#include "config_defaults.h"
 #include "robot.h"
 #include "string_utils.h"
+#include "servo_driver.h"
 
 /* Header */
 #include "configset_callbacks.h"
 
+/* Forward decs */
+static unsigned int configset_parse_cpus(const char *str);
+static void configset_parse_joint(JointDesc *joint, char *str);
+static JointDesc *configset_find_joint(Config *config, const char *name);
+
 void configset_log_file_dir(Config *config, void *data, bool is_string)
 {
     config->log_file_dir = (const char *) data;
@@ -142,6 +152,71 @@ void configset_pca_9685_hertz(Config *config, void *data, bool is_string)
     return;
 }
 
+void configset_pca_9685_burst(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->pca_9685_burst = str_equals((const char *) data, "true") ? true : false;
+    else
+    {
+        bool *data_p = (bool *) data;
+        config->pca_9685_burst = *data_p;
+    }
+
+    return;
+}
+
+void configset_pca_9685_i2c_bus(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->pca_9685_i2c_bus = (unsigned short) atoi((const char *) data);
+    else
+    {
+        unsigned short *data_p = (unsigned short *) data;
+        config->pca_9685_i2c_bus = *data_p;
+    }
+
+    return;
+}
+
+void configset_pca_9685_address(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->pca_9685_address = (unsigned short) strtol((const char *) data, NULL, 0);
+    else
+    {
+        unsigned short *data_p = (unsigned short *) data;
+        config->pca_9685_address = *data_p;
+    }
+
+    return;
+}
+
+void configset_pca_9685_limits_hertz(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->pca_9685_limits_hertz = (unsigned int) atoi((const char *) data);
+    else
+    {
+        unsigned int *data_p = (unsigned int *) data;
+        config->pca_9685_limits_hertz = *data_p;
+    }
+
+    return;
+}
+
+void configset_servo_driver(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->servo_driver = srvdrv_str_to_type((const char *) data);
+    else
+    {
+        unsigned short *data_p = (unsigned short *) data;
+        config->servo_driver = *data_p;
+    }
+
+    return;
+}
+
 void configset_servos_num(Config *config, void *data, bool is_string)
 {
     if (is_string)
@@ -152,6 +227,9 @@ void configset_servos_num(Config *config, void *data, bool is_string)
         config->servos_num = *data_p;
     }
 
+    if (config->servos_num > DEFAULT_JOINTS_MAX)
+        config->servos_num = DEFAULT_JOINTS_MAX;
+
     return;
 }
 
@@ -168,6 +246,58 @@ void configset_robot_tick(Config *config, void *data, bool is_string)
     return;
 }
 
+void configset_robot_refresh_ticks(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->robot_refresh_ticks = (unsigned short) atoi((const char *) data);
+    else
+    {
+        unsigned short *data_p = (unsigned short *) data;
+        config->robot_refresh_ticks = *data_p;
+    }
+
+    return;
+}
+
+void configset_robot_pwm_sync(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->robot_pwm_sync = str_equals((const char *) data, "true") ? true : false;
+    else
+    {
+        bool *data_p = (bool *) data;
+        config->robot_pwm_sync = *data_p;
+    }
+
+    return;
+}
+
+void configset_robot_pwm_lead(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->robot_pwm_lead = (double) atof((const char *) data);
+    else
+    {
+        double *data_p = (double *) data;
+        config->robot_pwm_lead = *data_p;
+    }
+
+    return;
+}
+
+void configset_robot_unified_loop(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->robot_unified_loop = str_equals((const char *) data, "true") ? true : false;
+    else
+    {
+        bool *data_p = (bool *) data;
+        config->robot_unified_loop = *data_p;
+    }
+
+    return;
+}
+
 void configset_transitions_enable(Config *config, void *data, bool is_string)
 {
     if (is_string)
@@ -194,6 +324,246 @@ void configset_transition_time(Config *config, void *data, bool is_string)
     return;
 }
 
+void configset_keyframe_queue_size(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->keyframe_queue_size = (unsigned int) atoi((const char *) data);
+    else
+    {
+        unsigned int *data_p = (unsigned int *) data;
+        config->keyframe_queue_size = *data_p;
+    }
+
+    return;
+}
+
+void configset_easing_lut(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->easing_lut = str_equals((const char *) data, "true") ? true : false;
+    else
+    {
+        bool *data_p = (bool *) data;
+        config->easing_lut = *data_p;
+    }
+
+    return;
+}
+
+void configset_keyframe_spline(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->keyframe_spline = str_equals((const char *) data, "true") ? true : false;
+    else
+    {
+        bool *data_p = (bool *) data;
+        config->keyframe_spline = *data_p;
+    }
+
+    return;
+}
+
+void configset_blend_time(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->blend_time = (double) atof((const char *) data);
+    else
+    {
+        double *data_p = (double *) data;
+        config->blend_time = *data_p;
+    }
+
+    return;
+}
+
+void configset_cpg_frequency(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->cpg_frequency = (double) atof((const char *) data);
+    else
+    {
+        double *data_p = (double *) data;
+        config->cpg_frequency = *data_p;
+    }
+
+    return;
+}
+
+void configset_cpg_smoothing(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->cpg_smoothing = (double) atof((const char *) data);
+    else
+    {
+        double *data_p = (double *) data;
+        config->cpg_smoothing = *data_p;
+    }
+
+    return;
+}
+
+void configset_leg_femur_length(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->leg_femur_length = (double) atof((const char *) data);
+    else
+    {
+        double *data_p = (double *) data;
+        config->leg_femur_length = *data_p;
+    }
+
+    return;
+}
+
+void configset_leg_tibia_length(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->leg_tibia_length = (double) atof((const char *) data);
+    else
+    {
+        double *data_p = (double *) data;
+        config->leg_tibia_length = *data_p;
+    }
+
+    return;
+}
+
+void configset_leg_joint_range(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->leg_joint_range = (double) atof((const char *) data);
+    else
+    {
+        double *data_p = (double *) data;
+        config->leg_joint_range = *data_p;
+    }
+
+    return;
+}
+
+void configset_leg_knee_zero(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->leg_knee_zero = (double) atof((const char *) data);
+    else
+    {
+        double *data_p = (double *) data;
+        config->leg_knee_zero = *data_p;
+    }
+
+    return;
+}
+
+void configset_motion_library(Config *config, void *data, bool is_string)
+{
+    snprintf(config->motion_library, sizeof(config->motion_library), "%s", (const char *) data);
+    return;
+}
+
+void configset_rt_enable(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->rt_enable = str_equals((const char *) data, "true") ? true : false;
+    else
+    {
+        bool *data_p = (bool *) data;
+        config->rt_enable = *data_p;
+    }
+
+    return;
+}
+
+void configset_rt_mlockall(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->rt_mlockall = str_equals((const char *) data, "true") ? true : false;
+    else
+    {
+        bool *data_p = (bool *) data;
+        config->rt_mlockall = *data_p;
+    }
+
+    return;
+}
+
+void configset_rt_robot_priority(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->rt_robot_priority = (unsigned short) atoi((const char *) data);
+    else
+    {
+        unsigned short *data_p = (unsigned short *) data;
+        config->rt_robot_priority = *data_p;
+    }
+
+    return;
+}
+
+void configset_rt_robot_cpus(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->rt_robot_cpus = configset_parse_cpus((const char *) data);
+    else
+    {
+        unsigned int *data_p = (unsigned int *) data;
+        config->rt_robot_cpus = *data_p;
+    }
+
+    return;
+}
+
+void configset_rt_keyfr_priority(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->rt_keyfr_priority = (unsigned short) atoi((const char *) data);
+    else
+    {
+        unsigned short *data_p = (unsigned short *) data;
+        config->rt_keyfr_priority = *data_p;
+    }
+
+    return;
+}
+
+void configset_rt_keyfr_cpus(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->rt_keyfr_cpus = configset_parse_cpus((const char *) data);
+    else
+    {
+        unsigned int *data_p = (unsigned int *) data;
+        config->rt_keyfr_cpus = *data_p;
+    }
+
+    return;
+}
+
+void configset_rt_events_priority(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->rt_events_priority = (unsigned short) atoi((const char *) data);
+    else
+    {
+        unsigned short *data_p = (unsigned short *) data;
+        config->rt_events_priority = *data_p;
+    }
+
+    return;
+}
+
+void configset_rt_events_cpus(Config *config, void *data, bool is_string)
+{
+    if (is_string)
+        config->rt_events_cpus = configset_parse_cpus((const char *) data);
+    else
+    {
+        unsigned int *data_p = (unsigned int *) data;
+        config->rt_events_cpus = *data_p;
+    }
+
+    return;
+}
+
 void configset_walk_hip_delta(Config *config, void *data, bool is_string)
 {
     if (is_string)
@@ -249,19 +619,84 @@ void configset_walk_knee_pad_b(Config *config, void *data, bool is_string)
 void configset_servo_pins(Config *config, void *data, bool is_string)
 {
     ServoPinData *data_p = (ServoPinData *) data;
-    config->servo_pins[data_p->id] = data_p->val;
+    if (data_p->id >= DEFAULT_JOINTS_MAX)
+        return;
+
+    config->joints[data_p->id].channel = data_p->val;
     return;
 }
 
 void configset_servo_limits(Config *config, void *data, bool is_string)
 {
     ServoLimitData *data_p = (ServoLimitData *) data;
-    ServoLimit *servo_limit = &(config->servo_limits[data_p->id]);
+    if (data_p->id >= DEFAULT_JOINTS_MAX)
+        return;
+
+    ServoLimit *servo_limit = &(config->joints[data_p->id].limits);
     servo_limit->min = data_p->min;
     servo_limit->max = data_p->max;
     return;
 }
 
+/*
+ A joint whose name is already known replaces that descriptor; any other is added 
+ after the last joint, growing servos_num.
+ */
+void configset_joints(Config *config, void *data, bool is_string)
+{
+    JointDesc parsed;
+    JointDesc *joint_data = &parsed;
+
+    if (is_string)
+        configset_parse_joint(&parsed, (char *) data);
+    else
+        joint_data = (JointDesc *) data;
+
+    if (joint_data->board >= DEFAULT_PCA_9685_BOARDS_MAX)
+        APP_ERROR("Joint is on a PCA-9685 board past the supported number of boards.", 1);
+
+    JointDesc *joint = configset_find_joint(config, joint_data->name);
+    if (!joint)
+    {
+        if (config->servos_num >= DEFAULT_JOINTS_MAX)
+            APP_ERROR("Too many joints in config.", 1);
+
+        joint = &(config->joints[config->servos_num++]);
+    }
+
+    *joint = *joint_data;
+    return;
+}
+
+void configset_pca_9685_boards(Config *config, void *data, bool is_string)
+{
+    PCA9685BoardData board_data;
+
+    if (is_string)
+    {
+        char *id_tok = strtok((char *) data, " \t");
+        char *bus_tok = strtok(NULL, " \t");
+        char *address_tok = strtok(NULL, " \t");
+        if (!id_tok || !bus_tok || !address_tok)
+            APP_ERROR("Malformed pca_9685_board line in config.", 1);
+
+        board_data.id = (unsigned short) atoi(id_tok);
+        board_data.bus = (unsigned short) atoi(bus_tok);
+        board_data.address = (unsigned short) strtol(address_tok, NULL, 0);
+    }
+    else
+        board_data = *((PCA9685BoardData *) data);
+
+    if (board_data.id >= DEFAULT_PCA_9685_BOARDS_MAX)
+        APP_ERROR("PCA-9685 board index past the supported number of boards.", 1);
+
+    PCA9685Board *board = &(config->pca_9685_boards[board_data.id]);
+    board->configured = true;
+    board->bus = board_data.bus;
+    board->address = board_data.address;
+    return;
+}
+
 void configset_http_enabled(Config *config, void *data, bool is_string)
 {
     if (is_string)
@@ -288,4 +723,88 @@ void configset_http_port(Config *config, void *data, bool is_string)
     return;
 }
 
-#endif
\ No newline at end of file
+/*
+ Parse a CPU list, such as "0,2-3", into a bit mask; CPUs outside of the mask's 
+ width are ignored.
+ */
+static unsigned int configset_parse_cpus(const char *str)
+{
+    unsigned int mask = 0;
+    const char *cursor = str;
+    char *end;
+    long first, last;
+
+    if (!str)
+        return 0;
+
+    while (*cursor != '\0')
+    {
+        first = strtol(cursor, &end, 10);
+        if (end == cursor)
+            break;
+
+        last = first;
+        if (*end == '-')
+        {
+            cursor = end + 1;
+            last = strtol(cursor, &end, 10);
+            if (end == cursor)
+                break;
+        }
+
+        for (long cpu = first; cpu <= last; cpu++)
+        {
+            if (cpu >= 0 && cpu < (long) (sizeof(mask) * 8))
+                mask |= 1U << cpu;
+        }
+
+        cursor = end;
+        if (*cursor == ',')
+            cursor++;
+    }
+
+    return mask;
+}
+
+/*
+ Parse a joint line of "name board channel inverted min-max [tags]".
+ */
+static void configset_parse_joint(JointDesc *joint, char *str)
+{
+    char *name = strtok(str, " \t");
+    char *board = strtok(NULL, " \t");
+    char *channel = strtok(NULL, " \t");
+    char *inverted = strtok(NULL, " \t");
+    char *limits = strtok(NULL, " \t");
+    char *tags = strtok(NULL, " \t");
+
+    if (!name || !board || !channel || !inverted || !limits)
+        APP_ERROR("Malformed joint line in config.", 1);
+
+    memset(joint, 0, sizeof(JointDesc));
+    strncpy(joint->name, name, JOINT_NAME_MAXLEN - 1);
+    joint->board = (unsigned short) atoi(board);
+    joint->channel = (unsigned short) atoi(channel);
+    joint->inverted = str_equals(inverted, "true");
+
+    char *min_tok = strtok(limits, "-");
+    char *max_tok = strtok(NULL, "-");
+    joint->limits.min = min_tok ? (unsigned short) atoi(min_tok) : 0;
+    joint->limits.max = max_tok ? (unsigned short) atoi(max_tok) : 0;
+
+    if (tags)
+        strncpy(joint->tags, tags, JOINT_TAGS_MAXLEN - 1);
+}
+
+static JointDesc *configset_find_joint(Config *config, const char *name)
+{
+    for (unsigned short i = 0; i < config->servos_num; i++)
+    {
+        if (str_equals(config->joints[i].name, name))
+            return &(config->joints[i]);
+    }
+
+    return NULL;
+}
+
+#endif
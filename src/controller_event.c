@@ -149,6 +149,52 @@ bool cntlevent_reset(MVCData *mvc_data)
     return true;
 }
 
+/* Every field is optional and defaults to 0, so a client can send only what its stick moves. */
+bool cntlevent_gait(MVCData *mvc_data)
+{
+    const char *names[] = { "forward", "lateral", "yaw", "step_height" };
+    double values[4] = { 0.0, 0.0, 0.0, 0.0 };
+
+    for (unsigned short i = 0; i < 4; i++)
+    {
+        cJSON *value_jp = cJSON_GetObjectItem(mvc_data->request_json, names[i]);
+        if (!value_jp)
+            continue;
+
+        if (!cJSON_IsNumber(value_jp))
+            return false;
+
+        values[i] = (double) value_jp->valuedouble;
+    }
+
+    EventGaitData event_gait_data;
+    event_gait_data.forward = values[0];
+    event_gait_data.lateral = values[1];
+    event_gait_data.yaw = values[2];
+    event_gait_data.step_height = values[3];
+
+    event_add(EVENT_GAIT, (void *) &event_gait_data);
+    return true;
+}
+
+bool cntlevent_motion(MVCData *mvc_data)
+{
+    cJSON *name_jp = cJSON_GetObjectItem(mvc_data->request_json, "name");
+    if (!name_jp || !cJSON_IsString(name_jp))
+        return false;
+
+    cJSON *cycles_jp = cJSON_GetObjectItem(mvc_data->request_json, "cycles");
+    if (!cycles_jp || !cJSON_IsNumber(cycles_jp))
+        return false;
+
+    EventMotionData event_motion_data;
+    snprintf(event_motion_data.name, sizeof(event_motion_data.name), "%s", name_jp->valuestring);
+    event_motion_data.cycles = (unsigned short) cycles_jp->valuedouble;
+
+    event_add(EVENT_MOTION, (void *) &event_motion_data);
+    return true;
+}
+
 bool cntlevent_halt(MVCData *mvc_data)
 {
     event_add(EVENT_HALT, (void *) NULL);
@@ -0,0 +1,63 @@
+#ifndef CONTROLLER_TIMING_DEF
+#define CONTROLLER_TIMING_DEF
+
+/*
+ File:          controller_timing.c
+ Description:   Controller functions for the control loop timing statistics.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+/* System includes */
+#include <stdio.h>
+#include <stdbool.h>
+
+/* Libraries */
+#include "cJSON.h"
+
+/* Application includes */
+#include "robot.h"
+#include "timing_stats.h"
+#include "mvc_data.h"
+
+/* Header */
+#include "controller_timing.h"
+
+bool cntltiming_getval(MVCData *mvc_data)
+{
+    TimingSummary summary;
+    RobotTickStats tick_stats;
+    robot_get_tickstats(&tick_stats);
+
+    cJSON *stages = cJSON_CreateObject();
+    cJSON *stage;
+
+    for (unsigned short i = 0; i < TMSTATS_NUM; i++)
+    {
+        tmstats_get(i, &summary);
+
+        stage = cJSON_CreateObject();
+        cJSON_AddItemToObject(stages, tmstats_stage_name(i), stage);
+        cJSON_AddNumberToObject(stage, "count", summary.count);
+        cJSON_AddNumberToObject(stage, "mean_us", summary.mean);
+        cJSON_AddNumberToObject(stage, "p50_us", summary.p50);
+        cJSON_AddNumberToObject(stage, "p99_us", summary.p99);
+        cJSON_AddNumberToObject(stage, "max_us", summary.max);
+    }
+
+    cJSON_AddItemToObject(mvc_data->response_json, "stages", stages);
+    cJSON_AddNumberToObject(mvc_data->response_json, "ticks", tick_stats.ticks);
+    cJSON_AddNumberToObject(mvc_data->response_json, "overruns", tick_stats.overruns);
+    cJSON_AddNumberToObject(mvc_data->response_json, "skipped", tick_stats.skipped);
+    cJSON_AddNumberToObject(mvc_data->response_json, "write_errors", tick_stats.write_errors);
+
+    return true;
+}
+
+bool cntltiming_reset(MVCData *mvc_data)
+{
+    tmstats_reset();
+    return true;
+}
+
+#endif
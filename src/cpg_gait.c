@@ -0,0 +1,176 @@
+#ifndef CPG_GAIT_DEF
+#define CPG_GAIT_DEF
+
+/*
+ File:          cpg_gait.c
+ Description:   Implementation of the oscillator driven trot gait.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+/* System includes */
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <math.h>
+#include <time.h>
+
+/* Application includes */
+#include "config_defaults.h"
+#include "config.h"
+#include "utils.h"
+#include "math_defs.h"
+
+/* Header */
+#include "cpg_gait.h"
+
+/* Hip and knee of each leg, and how it takes part in each kind of motion. */
+typedef struct CpgLeg {
+    unsigned short hip;
+    unsigned short knee;
+    double phase;
+    double side;
+    double end;
+} CpgLeg;
+
+/* Forward decs */
+static double cpg_clamp(double val, double min, double max);
+
+/*
+ Diagonal pairs step together, half a cycle apart. side and end give the hip's swing
+ direction for forward and lateral motion, as in the walk and strafe keyframes.
+ */
+static const CpgLeg legs[CPG_LEGS] = {
+    { SERVO_INDEX_FRONT_LEFT_HIP, SERVO_INDEX_FRONT_LEFT_KNEE, 0.0, -1.0, 1.0 },
+    { SERVO_INDEX_BACK_RIGHT_HIP, SERVO_INDEX_BACK_RIGHT_KNEE, 0.0, 1.0, -1.0 },
+    { SERVO_INDEX_FRONT_RIGHT_HIP, SERVO_INDEX_FRONT_RIGHT_KNEE, 0.5, 1.0, 1.0 },
+    { SERVO_INDEX_BACK_LEFT_HIP, SERVO_INDEX_BACK_LEFT_KNEE, 0.5, -1.0, -1.0 }
+};
+
+static pthread_mutex_t command_lock = PTHREAD_MUTEX_INITIALIZER;
+static CpgCommand command;
+static atomic_bool active;
+static atomic_bool restart;
+
+// Stepping thread only.
+static CpgCommand current;
+static CpgCommand smoothed;
+static double phase;
+static struct timespec last_time;
+
+void cpg_init()
+{
+    command = (CpgCommand) { 0.0, 0.0, 0.0, 0.0 };
+    atomic_init(&active, false);
+    atomic_init(&restart, false);
+}
+
+void cpg_set_command(const CpgCommand *new_command)
+{
+    pthread_mutex_lock(&command_lock);
+    command.forward = cpg_clamp(new_command->forward, -1.0, 1.0);
+    command.lateral = cpg_clamp(new_command->lateral, -1.0, 1.0);
+    command.yaw = cpg_clamp(new_command->yaw, -1.0, 1.0);
+    command.step_height = cpg_clamp(new_command->step_height, 0.0, 1.0);
+    pthread_mutex_unlock(&command_lock);
+
+    if (!atomic_exchange(&active, true))
+        atomic_store(&restart, true);
+}
+
+void cpg_stop()
+{
+    atomic_store(&active, false);
+}
+
+bool cpg_active()
+{
+    return atomic_load(&active);
+}
+
+/*
+ Each leg's phase runs 0 to 1; the first half is its swing, lifting the knee and
+ sweeping the hip from one extreme to the other, and the second half its stance,
+ sweeping back with the foot down. The commands are followed through a first order
+ filter and the hips follow cosines, so a change mid-stride never steps a joint. The
+ command is only taken if its lock is free, so the stepping thread never waits on it.
+ */
+bool cpg_eval(const struct timespec *time, AnimReal *pos, size_t len)
+{
+    // Every start sets restart, so a stop and start between two ticks is still seen here.
+    bool restarted = atomic_exchange(&restart, false);
+    if (restarted)
+    {
+        smoothed = (CpgCommand) { 0.0, 0.0, 0.0, 0.0 };
+        phase = 0.0;
+        last_time = *time;
+    }
+
+    if (pthread_mutex_trylock(&command_lock) == 0)
+    {
+        current = command;
+        pthread_mutex_unlock(&command_lock);
+    }
+
+    double *frequency = (double *) config_get(CONF_CPG_FREQUENCY);
+    double *smoothing = (double *) config_get(CONF_CPG_SMOOTHING);
+    double *hip_delta = (double *) config_get(CONF_WALK_HIP_DELTA);
+    double *knee_delta = (double *) config_get(CONF_WALK_KNEE_DELTA);
+
+    double dt = utils_timediff(*time, last_time);
+    dt = dt > 0.0 ? dt : 0.0;
+    last_time = *time;
+
+    double follow = *smoothing > 0.0 ? 1.0 - exp(-dt / *smoothing) : 1.0;
+    smoothed.forward += (current.forward - smoothed.forward) * follow;
+    smoothed.lateral += (current.lateral - smoothed.lateral) * follow;
+    smoothed.yaw += (current.yaw - smoothed.yaw) * follow;
+    smoothed.step_height += (current.step_height - smoothed.step_height) * follow;
+
+    phase += *frequency * dt;
+    phase -= floor(phase);
+
+    // Lift less for short strides, so the legs settle when the velocities reach zero.
+    double speed = fmax(fabs(smoothed.forward), fmax(fabs(smoothed.lateral), fabs(smoothed.yaw)));
+    double lift = (CPG_KNEE_STANCE + *knee_delta) * smoothed.step_height * fmin(speed, 1.0);
+
+    for (unsigned short l = 0; l < CPG_LEGS; l++)
+    {
+        const CpgLeg *leg = &legs[l];
+        if (leg->hip >= len || leg->knee >= len)
+            continue;
+
+        double amplitude = *hip_delta * cpg_clamp(smoothed.forward * leg->side + smoothed.lateral * leg->end + smoothed.yaw, -1.0, 1.0);
+
+        double leg_phase = phase + leg->phase;
+        leg_phase -= floor(leg_phase);
+
+        double hip, knee;
+        if (leg_phase < 0.5)
+        {
+            double u = leg_phase * 2.0;
+            hip = -amplitude * cos(M_PI * u);
+            knee = CPG_KNEE_STANCE - lift * sin(M_PI * u);
+        }
+        else
+        {
+            double u = (leg_phase - 0.5) * 2.0;
+            hip = amplitude * cos(M_PI * u);
+            knee = CPG_KNEE_STANCE;
+        }
+
+        pos[leg->hip] = ANIM_REAL(hip);
+        pos[leg->knee] = ANIM_REAL(knee);
+    }
+
+    return restarted;
+}
+
+static double cpg_clamp(double val, double min, double max)
+{
+    return val < min ? min : (val > max ? max : val);
+}
+
+#endif
@@ -0,0 +1,186 @@
+#ifndef DRIVER_PCA9685_DEF
+#define DRIVER_PCA9685_DEF
+
+/*
+ File:          driver_pca9685.c
+ Description:   Implementation of the PCA-9685 servo driver backend.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+/* System includes */
+#include <stdbool.h>
+#include <errno.h>
+
+/* Raspberry Pi libraries */
+#ifndef PEABOT_HOST
+#include <wiringPi.h>
+#include <pca9685.h>
+#endif
+
+/* Application includes */
+#include "config.h"
+#include "config_defaults.h"
+#include "servo_driver.h"
+#include "pca9685_i2c.h"
+
+/* Header */
+#include "driver_pca9685.h"
+
+/* Forward decs */
+static void drvpca_board_location(unsigned short board, unsigned short *bus, unsigned short *address);
+
+static bool             burst;
+static unsigned short   boards_open = 0;
+static PCA9685Dev       devs[DEFAULT_PCA_9685_BOARDS_MAX];
+
+#ifndef PEABOT_HOST
+static int              wiringpi_fds[DEFAULT_PCA_9685_BOARDS_MAX];
+#endif
+
+int drvpca_init(unsigned short boards_num)
+{
+    unsigned int *pin_base = (unsigned int *) config_get(CONF_PCA_9685_PIN_BASE);
+    unsigned int *hertz = (unsigned int *) config_get(CONF_PCA_9685_HERTZ);
+    bool *pca_9685_burst = (bool *) config_get(CONF_PCA_9685_BURST);
+
+    unsigned short bus, address;
+    int error;
+
+    if (boards_num > DEFAULT_PCA_9685_BOARDS_MAX)
+        return EINVAL;
+
+    burst = *pca_9685_burst;
+    boards_open = 0;
+
+    for (unsigned short i = 0; i < boards_num; i++)
+    {
+        drvpca_board_location(i, &bus, &address);
+
+        if (burst)
+            error = pcai2c_open(&devs[i], bus, address, *hertz);
+        else
+        {
+            #ifdef PEABOT_HOST
+            (void) pin_base;
+            error = ENOTSUP;
+            #else
+            wiringpi_fds[i] = pca9685Setup(*pin_base + i * DRVPCA_PIN_STRIDE, address, *hertz);
+            error = wiringpi_fds[i] < 0 ? EIO : 0;
+            #endif
+        }
+
+        if (error)
+        {
+            drvpca_halt();
+            return error;
+        }
+
+        boards_open++;
+    }
+
+    return 0;
+}
+
+/*
+ In burst mode, the dirty channels are sent as one auto-incremented write spanning 
+ the lowest to the highest of them; otherwise each one is written through wiringPi.
+ */
+int drvpca_write(unsigned short board, const unsigned short *frame, unsigned int dirty_mask)
+{
+    if (!dirty_mask)
+        return 0;
+
+    if (board >= boards_open)
+        return -ENODEV;
+
+    unsigned short first = __builtin_ctz(dirty_mask);
+    unsigned short last = 31 - __builtin_clz(dirty_mask);
+
+    if (burst)
+    {
+        int error = pcai2c_write(&devs[board], first, &frame[first], last - first + 1);
+        return error ? -error : last - first + 1;
+    }
+
+    #ifdef PEABOT_HOST
+    return -ENOTSUP;
+    #else
+    unsigned int *pin_base = (unsigned int *) config_get(CONF_PCA_9685_PIN_BASE);
+    unsigned int board_base = *pin_base + board * DRVPCA_PIN_STRIDE;
+    int sent = 0;
+
+    for (unsigned short i = first; i <= last; i++)
+    {
+        if (!(dirty_mask & (1U << i)))
+            continue;
+
+        pwmWrite(board_base + i, frame[i]);
+        sent++;
+    }
+
+    return sent;
+    #endif
+}
+
+int drvpca_frame_timing(long long *period_ns, struct timespec *frame_start)
+{
+    unsigned int *hertz = (unsigned int *) config_get(CONF_PCA_9685_HERTZ);
+
+    if (!burst || !boards_open)
+        return ENOTSUP;
+
+    *period_ns = pcai2c_period_ns(*hertz);
+    *frame_start = devs[0].restarted;
+    return 0;
+}
+
+void drvpca_reset()
+{
+    for (unsigned short i = 0; i < boards_open; i++)
+    {
+        if (burst)
+        {
+            pcai2c_reset(&devs[i]);
+            continue;
+        }
+
+        #ifndef PEABOT_HOST
+        pca9685PWMReset(wiringpi_fds[i]);
+        #endif
+    }
+}
+
+void drvpca_halt()
+{
+    if (burst)
+    {
+        for (unsigned short i = 0; i < boards_open; i++)
+            pcai2c_close(&devs[i]);
+    }
+
+    boards_open = 0;
+}
+
+/*
+ Boards without a pca_9685_board line sit on the default bus, at consecutive 
+ addresses from the default one.
+ */
+static void drvpca_board_location(unsigned short board, unsigned short *bus, unsigned short *address)
+{
+    PCA9685Board *boards = (PCA9685Board *) config_get(CONF_PCA_9685_BOARDS);
+    unsigned short *i2c_bus = (unsigned short *) config_get(CONF_PCA_9685_I2C_BUS);
+    unsigned short *i2c_address = (unsigned short *) config_get(CONF_PCA_9685_ADDRESS);
+
+    if (boards[board].configured)
+    {
+        *bus = boards[board].bus;
+        *address = boards[board].address;
+        return;
+    }
+
+    *bus = *i2c_bus;
+    *address = *i2c_address + board;
+}
+
+#endif
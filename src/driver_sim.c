@@ -0,0 +1,175 @@
+#ifndef DRIVER_SIM_DEF
+#define DRIVER_SIM_DEF
+
+/*
+ File:          driver_sim.c
+ Description:   Implementation of the simulated PCA-9685 servo driver backend.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+/* System includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+
+/* Application includes */
+#include "config_defaults.h"
+#include "servo_driver.h"
+#include "utils.h"
+#include "config.h"
+#include "pca9685_i2c.h"
+
+/* Header */
+#include "driver_sim.h"
+
+/* Forward decs */
+static void drvsim_record(struct timespec time, unsigned short board, unsigned short channel, unsigned short count);
+
+static SimServoWrite    *writes = NULL;
+static size_t           writes_len = DEFAULT_SIM_LOG_SIZE;
+static unsigned long    write_count = 0;
+static unsigned short   boards = 0;
+static struct timespec  started;
+static unsigned short   channels[DEFAULT_PCA_9685_BOARDS_MAX][SERVO_DRIVER_CHANNELS];
+static pthread_mutex_t  lock = PTHREAD_MUTEX_INITIALIZER;
+
+int drvsim_init(unsigned short boards_num)
+{
+    if (boards_num > DEFAULT_PCA_9685_BOARDS_MAX)
+        return EINVAL;
+    boards = boards_num;
+
+    writes = calloc(writes_len, sizeof(SimServoWrite));
+    if (!writes)
+        return ENOMEM;
+
+    write_count = 0;
+    memset(channels, 0, sizeof(channels));
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    return 0;
+}
+
+int drvsim_write(unsigned short board, const unsigned short *frame, unsigned int dirty_mask)
+{
+    if (board >= boards)
+        return -ENODEV;
+
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    int sent = 0;
+
+    pthread_mutex_lock(&lock);
+    for (unsigned short i = 0; i < SERVO_DRIVER_CHANNELS; i++)
+    {
+        if (!(dirty_mask & (1U << i)))
+            continue;
+
+        drvsim_record(time, board, i, frame[i]);
+        sent++;
+    }
+    pthread_mutex_unlock(&lock);
+
+    return sent;
+}
+
+int drvsim_frame_timing(long long *period_ns, struct timespec *frame_start)
+{
+    unsigned int *hertz = (unsigned int *) config_get(CONF_PCA_9685_HERTZ);
+
+    *period_ns = pcai2c_period_ns(*hertz);
+    *frame_start = started;
+    return 0;
+}
+
+void drvsim_reset()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    pthread_mutex_lock(&lock);
+    for (unsigned short b = 0; b < boards; b++)
+    {
+        for (unsigned short i = 0; i < SERVO_DRIVER_CHANNELS; i++)
+            drvsim_record(time, b, i, 0);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void drvsim_halt()
+{
+    pthread_mutex_lock(&lock);
+    if (writes)
+        free(writes);
+    writes = NULL;
+    pthread_mutex_unlock(&lock);
+}
+
+unsigned short drvsim_get_channel(unsigned short board, unsigned short channel)
+{
+    if (board >= boards || channel >= SERVO_DRIVER_CHANNELS)
+        return 0;
+
+    return channels[board][channel];
+}
+
+unsigned long drvsim_get_write_count()
+{
+    return write_count;
+}
+
+size_t drvsim_get_writes(SimServoWrite *dest, size_t len)
+{
+    pthread_mutex_lock(&lock);
+
+    size_t stored = write_count < writes_len ? write_count : writes_len;
+    if (len > stored)
+        len = stored;
+
+    if (!writes)
+        len = 0;
+
+    for (size_t i = 0; i < len; i++)
+        dest[i] = writes[(write_count - len + i) % writes_len];
+
+    pthread_mutex_unlock(&lock);
+
+    return len;
+}
+
+size_t drvsim_dump(FILE *file)
+{
+    SimServoWrite *copy = calloc(writes_len, sizeof(SimServoWrite));
+    if (!copy)
+        return 0;
+
+    size_t len = drvsim_get_writes(copy, writes_len);
+    for (size_t i = 0; i < len; i++)
+        fprintf(file, "%.9f,%d,%d,%d\n", utils_timespec_to_secs(copy[i].time), copy[i].board, copy[i].channel, copy[i].count);
+
+    free(copy);
+    return len;
+}
+
+static void drvsim_record(struct timespec time, unsigned short board, unsigned short channel, unsigned short count)
+{
+    channels[board][channel] = count;
+
+    if (!writes)
+        return;
+
+    SimServoWrite *write = &writes[write_count % writes_len];
+    write->time = time;
+    write->board = board;
+    write->channel = channel;
+    write->count = count;
+    write_count++;
+}
+
+#endif
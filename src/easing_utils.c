@@ -8,7 +8,12 @@
  Author:        Matt Mumau
  */
 
-#include "stdio.h"
+/* System includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <math.h>
 
 /* Library includes */
 #include "easing.h"
@@ -16,121 +21,155 @@
 /* Header */
 #include "easing_utils.h"
 
-double easing_calc(unsigned short easing_type, AHFloat p)
+/* Forward decs */
+static double easing_lut_segment_err(const double *table, AHEasingFunction easing_func, unsigned int segment);
+
+/* Indexed by the EASE_ ids above. */
+static const AHEasingFunction easing_funcs[EASE_NUM] = {
+    LinearInterpolation,
+    QuadraticEaseIn, QuadraticEaseOut, QuadraticEaseInOut,
+    CubicEaseIn, CubicEaseOut, CubicEaseInOut,
+    QuarticEaseIn, QuarticEaseOut, QuarticEaseInOut,
+    QuinticEaseIn, QuinticEaseOut, QuinticEaseInOut,
+    SineEaseIn, SineEaseOut, SineEaseInOut,
+    CircularEaseIn, CircularEaseOut, CircularEaseInOut,
+    ExponentialEaseIn, ExponentialEaseOut, ExponentialEaseInOut,
+    ElasticEaseIn, ElasticEaseOut, ElasticEaseInOut,
+    BackEaseIn, BackEaseOut, BackEaseInOut,
+    BounceEaseIn, BounceEaseOut, BounceEaseInOut
+};
+
+static double *easing_lut = NULL;
+static double easing_lut_err[EASE_NUM];
+static bool easing_lut_usable[EASE_NUM];
+static bool lut_enabled = false;
+
+int easing_init(bool use_lut)
 {
-    if (easing_type == easing_type - 1)
-        return (double) p;
-
-    AHFloat (*easing_func)(AHFloat p);
-    easing_func = NULL;
-
-    if (easing_type == EASE_LINEAR)
-        easing_func = LinearInterpolation;
-
-
-    if (easing_type == EASE_QUAD_IN)
-        easing_func = QuadraticEaseIn;
-
-    if (easing_type == EASE_QUAD_OUT)
-        easing_func = QuadraticEaseOut;
-
-    if (easing_type == EASE_QUAD_INOUT)
-        easing_func = QuadraticEaseInOut;   
-
-
-    if (easing_type == EASE_CUBE_IN)
-        easing_func = CubicEaseIn;
-
-    if (easing_type == EASE_CUBE_OUT)
-        easing_func = CubicEaseOut;
-
-    if (easing_type == EASE_CUBE_INOUT)
-        easing_func = CubicEaseInOut;
-
-
-    if (easing_type == EASE_QUART_IN)
-        easing_func = QuarticEaseIn;
-
-    if (easing_type == EASE_QUART_OUT)
-        easing_func = QuarticEaseOut;
-
-    if (easing_type == EASE_QUART_INOUT)
-        easing_func = QuarticEaseInOut;
-
-
-    if (easing_type == EASE_QUINT_IN)
-        easing_func = QuinticEaseIn;
-
-    if (easing_type == EASE_QUINT_OUT)
-        easing_func = QuinticEaseOut;
-
-    if (easing_type == EASE_QUINT_INOUT)
-        easing_func = QuinticEaseInOut;     
-
-
-    if (easing_type == EASE_SINE_IN)
-        easing_func = SineEaseIn;
-
-    if (easing_type == EASE_SINE_OUT)
-        easing_func = SineEaseOut;
-
-    if (easing_type == EASE_SINE_INOUT)
-        easing_func = SineEaseInOut;    
+    if (!use_lut)
+        return 0;
 
+    int error = easing_lut_build();
+    if (error)
+        return error;
 
-    if (easing_type == EASE_CIRC_IN)
-        easing_func = CircularEaseIn;       
-
-    if (easing_type == EASE_CIRC_OUT)
-        easing_func = CircularEaseOut;  
+    lut_enabled = true;
+    return 0;
+}
 
-    if (easing_type == EASE_CIRC_INOUT)
-        easing_func = CircularEaseInOut;    
+void easing_destroy()
+{
+    lut_enabled = false;
 
+    if (easing_lut)
+        free(easing_lut);
+    easing_lut = NULL;
+}
 
-    if (easing_type == EASE_EXP_IN)
-        easing_func = ExponentialEaseIn;
+double easing_calc(unsigned short easing_type, AHFloat p)
+{
+    if (easing_type >= EASE_NUM)
+        return (double) p;
 
-    if (easing_type == EASE_EXP_OUT)
-        easing_func = ExponentialEaseOut;
+    if (lut_enabled && easing_lut_usable[easing_type])
+        return easing_calc_lut(easing_type, p);
 
-    if (easing_type == EASE_EXP_INOUT)
-        easing_func = ExponentialEaseInOut; 
+    return (double) easing_funcs[easing_type](p);
+}
 
+double easing_calc_direct(unsigned short easing_type, AHFloat p)
+{
+    if (easing_type >= EASE_NUM)
+        return (double) p;
 
-    if (easing_type == EASE_ELASTIC_IN)
-        easing_func = ElasticEaseIn;    
-        
-    if (easing_type == EASE_ELASTIC_OUT)
-        easing_func = ElasticEaseOut;   
+    return (double) easing_funcs[easing_type](p);
+}
 
-    if (easing_type == EASE_ELASTIC_INOUT)
-        easing_func = ElasticEaseInOut;     
+/*
+ Each table holds EASING_LUT_SIZE + 1 samples evenly spaced over 0 to 1, so the 
+ value at p is a straight line between the two samples either side of it. Inputs 
+ outside 0 to 1 are clamped; the keyframe handler never produces them.
+ */
+double easing_calc_lut(unsigned short easing_type, AHFloat p)
+{
+    if (easing_type >= EASE_NUM)
+        return (double) p;
 
+    if (p <= 0.0)
+        p = 0.0;
+    if (p >= 1.0)
+        p = 1.0;
 
-    if (easing_type == EASE_BACK_IN)
-        easing_func = BackEaseIn;       
+    const double *table = &easing_lut[easing_type * (EASING_LUT_SIZE + 1)];
+    double x = p * EASING_LUT_SIZE;
+    unsigned int i = (unsigned int) x;
+    if (i >= EASING_LUT_SIZE)
+        i = EASING_LUT_SIZE - 1;
 
-    if (easing_type == EASE_BACK_OUT)
-        easing_func = BackEaseOut;
+    double frac = x - (double) i;
+    return table[i] + (table[i + 1] - table[i]) * frac;
+}
 
-    if (easing_type == EASE_BACK_INOUT)
-        easing_func = BackEaseInOut;        
+/*
+ The error of every table is measured against its function at three points inside 
+ each segment while it is built. The circular curves have an infinite slope at one end 
+ which no table of this size follows closely, so any curve over EASING_LUT_MAXERR keeps 
+ being evaluated directly.
+ */
+int easing_lut_build()
+{
+    if (easing_lut)
+        return 0;
+
+    double *tables = calloc(EASE_NUM * (EASING_LUT_SIZE + 1), sizeof(double));
+    if (!tables)
+        return ENOMEM;
+
+    for (unsigned short type = 0; type < EASE_NUM; type++)
+    {
+        double *table = &tables[type * (EASING_LUT_SIZE + 1)];
+        for (unsigned int i = 0; i <= EASING_LUT_SIZE; i++)
+            table[i] = (double) easing_funcs[type]((AHFloat) i / EASING_LUT_SIZE);
+
+        double max_err = 0.0;
+        for (unsigned int i = 0; i < EASING_LUT_SIZE; i++)
+        {
+            double err = easing_lut_segment_err(table, easing_funcs[type], i);
+            if (err > max_err)
+                max_err = err;
+        }
+        easing_lut_err[type] = max_err;
+        easing_lut_usable[type] = max_err <= EASING_LUT_MAXERR;
+    }
+
+    easing_lut = tables;
+    return 0;
+}
 
+double easing_lut_maxerr(unsigned short easing_type)
+{
+    if (easing_type >= EASE_NUM || !easing_lut)
+        return 0.0;
 
-    if (easing_type == EASE_BOUNCE_IN)
-        easing_func = BounceEaseIn;         
+    return easing_lut_err[easing_type];
+}
 
-    if (easing_type == EASE_BOUNCE_OUT)
-        easing_func = BounceEaseOut;    
+static double easing_lut_segment_err(const double *table, AHEasingFunction easing_func, unsigned int segment)
+{
+    double max_err = 0.0;
 
-    if (easing_type == EASE_BOUNCE_INOUT)
-        easing_func = BounceEaseInOut;                              
+    for (unsigned int quarter = 1; quarter < 4; quarter++)
+    {
+        double frac = quarter / 4.0;
+        double p = (segment + frac) / EASING_LUT_SIZE;
+        double interp = table[segment] + (table[segment + 1] - table[segment]) * frac;
+        double err = fabs(interp - (double) easing_func((AHFloat) p));
 
-    if (easing_func)
-        return (double) (*easing_func)(p);
+        if (err > max_err)
+            max_err = err;
+    }
 
-    return (double) p;
+    return max_err;
 }
 
-#endif
\ No newline at end of file
+#endif
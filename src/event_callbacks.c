@@ -8,9 +8,12 @@
  Author:        Matt Mumau
  */
 
+#define _POSIX_C_SOURCE 199309L
+
 /* System includes */
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 /* Application includes */
 #include "config_defaults.h"
@@ -19,15 +22,22 @@
 #include "log.h"
 #include "events.h"
 #include "keyframe_handler.h"
+#include "cpg_gait.h"
+#include "motion_library.h"
+#include "utils.h"
 
 /* Header */
 #include "event_callbacks.h"
 
 /* Forward decs */
 static void eventcb_logcb(const char *msg);
+static bool eventcb_reserve(size_t needed, const char *name);
+static void eventcb_logmotion(const char *name);
+static void eventcb_redirect();
 
 void eventcb_reset(void *arg)
 {
+    eventcb_redirect();
     keyhandler_add(KEYFR_RESET, (void *) NULL, false, false);
     eventcb_logcb("Added KEYFR_RESET keyframe.");
 }
@@ -58,6 +68,7 @@ void eventcb_elevate(void *arg)
 
     *duration = elevate_data->duration; 
 
+    eventcb_redirect();
     keyhandler_add(KEYFR_ELEVATE, (void *) duration, reverse, false);
     eventcb_logcb("Added KEYFR_ELEVATE keyframe.");
 }
@@ -73,6 +84,7 @@ void eventcb_extend(void *arg)
 
     *duration = extend_data->duration;
 
+    eventcb_redirect();
     keyhandler_add(KEYFR_EXTEND, (void *) duration, reverse, false);
     eventcb_logcb("Added KEYFR_EXTEND keyframe.");
 }
@@ -87,6 +99,12 @@ void eventcb_walk(void *arg)
 
     double *duration_p;   
 
+    eventcb_redirect();
+
+    // Each cycle takes a slot, plus the leading transition and the trailing elevate with its transition.
+    if (!eventcb_reserve((size_t) cycles + 3, "KEYFR_WALK"))
+        return;
+
     for (unsigned short i = 0; i < cycles; i++)
     {
         duration_p = calloc(1, sizeof(double));
@@ -100,7 +118,7 @@ void eventcb_walk(void *arg)
 
     keyhandler_add(KEYFR_ELEVATE, (void *) NULL, false, false);
 
-    eventcb_logcb("Added KEYFR_WALK keyframes.");
+    eventcb_logmotion("KEYFR_WALK");
 }
 
 void eventcb_turn(void *arg)
@@ -113,6 +131,11 @@ void eventcb_turn(void *arg)
    
     double *duration_p;
 
+    eventcb_redirect();
+
+    if (!eventcb_reserve((size_t) cycles + 1, "KEYFR_TURN"))
+        return;
+
     for (unsigned short i = 0; i < cycles; i++)
     {
         duration_p = calloc(1, sizeof(double));
@@ -124,7 +147,7 @@ void eventcb_turn(void *arg)
         keyhandler_add(KEYFR_TURN, (void *) duration_p, reverse, i > 0);
     }
 
-    eventcb_logcb("Added KEYFR_TURN keyframes.");
+    eventcb_logmotion("KEYFR_TURN");
 }
 
 void eventcb_strafe(void *arg)
@@ -137,6 +160,11 @@ void eventcb_strafe(void *arg)
    
     double *duration_p;
 
+    eventcb_redirect();
+
+    if (!eventcb_reserve((size_t) cycles + 3, "KEYFR_STRAFE"))
+        return;
+
     for (unsigned short i = 0; i < cycles; i++)
     {
         duration_p = calloc(1, sizeof(double));
@@ -149,16 +177,114 @@ void eventcb_strafe(void *arg)
     }
 
     keyhandler_add(KEYFR_ELEVATE, (void *) NULL, false, false);
-    eventcb_logcb("Added KEYFR_STRAFE keyframes.");
+    eventcb_logmotion("KEYFR_STRAFE");
+}
+
+void eventcb_gait(void *arg)
+{
+    EventGaitData *gait_data = (EventGaitData *) arg;
+
+    if (!cpg_active())
+        keyhandler_removeall();
+
+    CpgCommand command = { gait_data->forward, gait_data->lateral, gait_data->yaw, gait_data->step_height };
+    cpg_set_command(&command);
+
+    eventcb_logcb("Set gait command.");
+}
+
+/*
+ Queued against the library loaded right now; a reload while the motion plays does not 
+ change it. The motion's first frame gets a transition, like the first cycle of a walk.
+ */
+void eventcb_motion(void *arg)
+{
+    EventMotionData *motion_data = (EventMotionData *) arg;
+    char log_msg[LOG_LINE_MAXLEN];
+
+    MotionLibrary *library = motlib_acquire();
+    const LibraryMotion *motion = motlib_find(library, motion_data->name);
+    if (!motion)
+    {
+        snprintf(log_msg, sizeof(log_msg), "[EVNT] No motion named %s in the motion library.", motion_data->name);
+        log_event(log_msg);
+
+        motlib_release(library);
+        return;
+    }
+
+    eventcb_redirect();
+
+    if (!eventcb_reserve(motion->frames_num * motion_data->cycles + 1, "KEYFR_LIBRARY"))
+    {
+        motlib_release(library);
+        return;
+    }
+
+    LibraryFrameRef *ref;
+    bool first = true;
+
+    for (unsigned short c = 0; c < motion_data->cycles; c++)
+    {
+        for (size_t f = 0; f < motion->frames_num; f++)
+        {
+            ref = calloc(1, sizeof(LibraryFrameRef));
+            if (!ref)
+                APP_ERROR("Could not allocate memory.", 1);
+
+            ref->library = library;
+            ref->frame = motion->first + f;
+
+            keyhandler_add(KEYFR_LIBRARY, (void *) ref, false, !first || library->frames[ref->frame]->is_delay);
+            first = false;
+        }
+    }
+
+    motlib_release(library);
+
+    snprintf(log_msg, sizeof(log_msg), "KEYFR_LIBRARY %s", motion_data->name);
+    eventcb_logmotion(log_msg);
 }
 
 void eventcb_halt(void *arg)
 {
+    cpg_stop();
     keyhandler_removeall();
 
     eventcb_logcb("Cleared all keyframes.");
 }
 
+/* A new command takes over from the motion in flight rather than waiting behind it; delays still queue. */
+static void eventcb_redirect()
+{
+    if (keyhandler_redirect())
+        eventcb_logcb("Redirected from the motion in flight.");
+}
+
+/* Rejects a multi-keyframe event up front, rather than queueing part of a gait. */
+static bool eventcb_reserve(size_t needed, const char *name)
+{
+    if (keyhandler_space() >= needed)
+        return true;
+
+    char log_msg[LOG_LINE_MAXLEN];
+    snprintf(log_msg, sizeof(log_msg), "[EVNT] Keyframe queue full; rejected %s event needing %zu slots.", name, needed);
+    log_event(log_msg);
+
+    return false;
+}
+
+static void eventcb_logmotion(const char *name)
+{
+    struct timespec now, done;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    keyhandler_completion(&done);
+
+    char msg[LOG_LINE_MAXLEN];
+    snprintf(msg, sizeof(msg), "Added %s keyframes. (done in: %.3f s)", name, utils_timediff(done, now));
+    eventcb_logcb(msg);
+}
+
 static void eventcb_logcb(const char *msg)
 {
     bool *log_event_callbacks = config_get(CONF_LOG_EVENT_CALLBACKS);
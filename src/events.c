@@ -24,13 +24,17 @@
 #include "log.h"
 #include "list.h"
 #include "event_callbacks.h"
+#include "rt_sched.h"
 
 /* Header */
 #include "events.h"
 
 static pthread_t event_thread;
+static bool thread_started = false;
 static bool running = true;
 static List *events;
+static pthread_mutex_t events_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t events_cond = PTHREAD_COND_INITIALIZER;
 
 /* Forward decs */
 static void event_destroy(Event *event);
@@ -44,14 +48,25 @@ void event_init()
     int error = pthread_create(&event_thread, NULL, event_main, NULL);
     if (error)
         APP_ERROR("Could not create thread.", error);
+    thread_started = true;
+
+    rtsched_apply(event_thread, RT_THREAD_EVENTS);
 }
 
 void event_halt()
 {
+    pthread_mutex_lock(&events_lock);
     running = false;
-    int error = pthread_join(event_thread, NULL);
-    if (error)
-        log_error("Could not rejoin from robot thread.", error);
+    pthread_cond_signal(&events_cond);
+    pthread_mutex_unlock(&events_lock);
+
+    if (thread_started)
+    {
+        int error = pthread_join(event_thread, NULL);
+        if (error)
+            log_error("Could not rejoin from robot thread.", error);
+    }
+    thread_started = false;
 
     if (events != NULL)
         free(events);
@@ -65,11 +80,17 @@ static void *event_main(void *arg)
     Event *event;
     void (*event_callback)(void *arg);
 
-    while (running)
+    while (true)
     {
-        event = (Event *) list_pop(&events);
+        // Waits for an event rather than polling, so it never holds the CPU from lower priority threads.
+        event = NULL;
+        pthread_mutex_lock(&events_lock);
+        while (running && !(event = (Event *) list_pop(&events)))
+            pthread_cond_wait(&events_cond, &events_lock);
+        pthread_mutex_unlock(&events_lock);
+
         if (!event)
-            continue;
+            break;
 
         #ifdef PEABOT_DBG
         printf("-------PROCESSING EVENT--------\n");
@@ -102,6 +123,12 @@ static void *event_main(void *arg)
         if (event->type == EVENT_STRAFE)
             event_callback = eventcb_strafe;
 
+        if (event->type == EVENT_GAIT)
+            event_callback = eventcb_gait;
+
+        if (event->type == EVENT_MOTION)
+            event_callback = eventcb_motion;
+
         if (!event_callback)
             continue;
 
@@ -134,8 +161,13 @@ void event_add(unsigned short event_type, void *data)
     event_print_event(event);
     #endif
 
-    list_push(&events, (void *) event);
+    // Prompt and HTTP threads both add events, and the event thread may free it as soon as it is pushed.
     event_log_eventadd(event);
+
+    pthread_mutex_lock(&events_lock);
+    list_push(&events, (void *) event);
+    pthread_cond_signal(&events_cond);
+    pthread_mutex_unlock(&events_lock);
 }
 
 static void event_destroy(Event *event)
@@ -197,6 +229,18 @@ static void *event_get_data_cpy(unsigned short event_type, void *data)
                 APP_ERROR("Could not allocate memory.", 1);  
             *((EventStrafeData *) data_p) = *((EventStrafeData *) data);
             break;
+        case EVENT_GAIT:
+            data_p = (void *) calloc(1, sizeof(EventGaitData));
+            if (!data_p)
+                APP_ERROR("Could not allocate memory.", 1);  
+            *((EventGaitData *) data_p) = *((EventGaitData *) data);
+            break;
+        case EVENT_MOTION:
+            data_p = (void *) calloc(1, sizeof(EventMotionData));
+            if (!data_p)
+                APP_ERROR("Could not allocate memory.", 1);  
+            *((EventMotionData *) data_p) = *((EventMotionData *) data);
+            break;
         default:
             return NULL;                            
     }
@@ -224,6 +268,10 @@ static char *event_getname(unsigned short event_type)
             return "EVENT_HALT";
         case EVENT_STRAFE:
             return "EVENT_STRAFE";
+        case EVENT_GAIT:
+            return "EVENT_GAIT";
+        case EVENT_MOTION:
+            return "EVENT_MOTION";
     }
 
     return NULL;
@@ -284,6 +332,18 @@ void event_print_event(Event *event)
             printf("\tEventStrafeData [duration]: %f\n", event_strafe_p->duration);
             printf("\tEventStrafeData [cycles]: %d\n", event_strafe_p->cycles);
 
+            break;
+        case EVENT_GAIT: ;
+            EventGaitData *event_gait_p = (EventGaitData *) event->data;
+            printf("\tEventGaitData [forward]: %f\n", event_gait_p->forward);
+            printf("\tEventGaitData [lateral]: %f\n", event_gait_p->lateral);
+            printf("\tEventGaitData [yaw]: %f\n", event_gait_p->yaw);
+            printf("\tEventGaitData [step_height]: %f\n", event_gait_p->step_height);
+            break;
+        case EVENT_MOTION: ;
+            EventMotionData *event_motion_p = (EventMotionData *) event->data;
+            printf("\tEventMotionData [name]: %s\n", event_motion_p->name);
+            printf("\tEventMotionData [cycles]: %d\n", event_motion_p->cycles);
             break;                               
     }
 }
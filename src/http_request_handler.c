@@ -29,6 +29,7 @@
 #include "mvc_data.h"
 #include "log.h"
 #include "controller_usd.h"
+#include "controller_timing.h"
 
 /* Header */
 #include "http_request_handler.h"
@@ -169,6 +170,14 @@ static void httprhnd_handle_post(MVCData *mvc_data)
                 post_cb = cntlevent_halt;  
             if (mvc_data->controller == CONTROLLER_STRAFE)
                 post_cb = cntlevent_strafe;
+            if (mvc_data->controller == CONTROLLER_GAIT)
+                post_cb = cntlevent_gait;
+            if (mvc_data->controller == CONTROLLER_MOTION)
+                post_cb = cntlevent_motion;
+            break;
+        case MODEL_TIMING:
+            if (mvc_data->controller == CONTROLLER_RESET)
+                post_cb = cntltiming_reset;
             break;
         default:
             mvc_data->http_response->code = HTTP_RC_BAD_REQUEST;
@@ -201,6 +210,10 @@ static void httprhnd_handle_get(MVCData *mvc_data)
             if (mvc_data->controller == CONTROLLER_GET)
                 get_cb = cntlusd_getval;
             break;
+        case MODEL_TIMING:
+            if (mvc_data->controller == CONTROLLER_GET)
+                get_cb = cntltiming_getval;
+            break;
     }
 
     bool success = false;
@@ -27,6 +27,11 @@
 /* Forward decs */
 static bool servopos_matches(ServoPos *src, ServoPos *dest, size_t len);
 static unsigned short get_knee_from_leg(unsigned short leg);
+static bool keyfactory_walk_phase(Keyframe *keyfr, size_t len, double duration, bool reverse, bool is_inverted);
+static bool keyfactory_strafe_phase(Keyframe *keyfr, size_t len, double duration, bool reverse, bool is_inverted);
+static bool keyfactory_turnsegment(Keyframe *keyfr, size_t len, const GaitState *state, double duration, bool reverse);
+static bool keyfactory_turn_complete(const GaitState *state);
+static void keyfactory_turn_advance(GaitState *state, bool reverse);
 
 bool keyfactory_reset(Keyframe *keyfr, size_t len, void *data, bool reverse)
 {
@@ -89,16 +94,68 @@ bool keyfactory_extend(Keyframe *keyfr, size_t len, void *data, bool reverse)
     return true;
 }
 
-bool keyfactory_walk(Keyframe *keyfr, size_t len, void *data, bool reverse)
+void keyfactory_gait_init(GaitState *state)
 {
-    if (!data)
-        return false;
+    *state = (GaitState) { 0, 0, SERVO_INDEX_FRONT_RIGHT_HIP, { false, false, false, false } };
+}
+
+/*
+ Walks and strafes alternate between two mirrored keyframes. Phase 0 is the first 
+ one a gait produces from a fresh state; each keyframe moves the gait on to its other phase.
+ */
+unsigned short keyfactory_gait_phase(const GaitState *state, unsigned short keyfr_type)
+{
+    return keyfr_type == KEYFR_STRAFE ? state->strafe_phase : state->walk_phase;
+}
+
+bool keyfactory_gait(Keyframe *keyfr, size_t len, unsigned short keyfr_type, double duration, bool reverse, unsigned short phase)
+{
+    if (keyfr_type == KEYFR_WALK)
+        return keyfactory_walk_phase(keyfr, len, duration, reverse, phase == 0);
+
+    if (keyfr_type == KEYFR_STRAFE)
+        return keyfactory_strafe_phase(keyfr, len, duration, reverse, phase == 0);
+
+    return false;
+}
+
+/* The state is copied first, so state and next may be the same struct. */
+void keyfactory_advance(const GaitState *state, GaitState *next, unsigned short keyfr_type, bool reverse)
+{
+    GaitState advanced = *state;
+
+    if (keyfr_type == KEYFR_WALK)
+        advanced.walk_phase = advanced.walk_phase ? 0 : 1;
+
+    if (keyfr_type == KEYFR_STRAFE)
+        advanced.strafe_phase = advanced.strafe_phase ? 0 : 1;
+
+    if (keyfr_type == KEYFR_TURN)
+        keyfactory_turn_advance(&advanced, reverse);
+
+    *next = advanced;
+}
 
-    static bool is_inverted = true;
+bool keyfactory_next(const GaitState *state, GaitState *next, Keyframe *keyfr, size_t len, unsigned short keyfr_type, double duration, bool reverse)
+{
+    bool success = false;
+
+    if (keyfr_type == KEYFR_WALK || keyfr_type == KEYFR_STRAFE)
+        success = keyfactory_gait(keyfr, len, keyfr_type, duration, reverse, keyfactory_gait_phase(state, keyfr_type));
+
+    if (keyfr_type == KEYFR_TURN)
+        success = keyfactory_turnsegment(keyfr, len, state, duration, reverse);
+
+    keyfactory_advance(state, next, keyfr_type, reverse);
+    return success;
+}
+
+static bool keyfactory_walk_phase(Keyframe *keyfr, size_t len, double duration, bool reverse, bool is_inverted)
+{
     double mod = (is_inverted ? -1.0 : 1.0) * (reverse ? -1.0 : 1.0);
 
-    double *duration = (double *) data;
-    keyfr->duration = *duration;
+    keyfr->duration = duration;
+    keyfr->is_delay = false;
 
     double *knee_delta = (double *) config_get(CONF_WALK_KNEE_DELTA);
     double *hip_delta = (double *) config_get(CONF_WALK_HIP_DELTA);
@@ -136,20 +193,15 @@ bool keyfactory_walk(Keyframe *keyfr, size_t len, void *data, bool reverse)
         }
     }
 
-    is_inverted = !is_inverted;
     return true;
 }
 
-bool keyfactory_strafe(Keyframe *keyfr, size_t len, void *data, bool reverse)
+static bool keyfactory_strafe_phase(Keyframe *keyfr, size_t len, double duration, bool reverse, bool is_inverted)
 {
-    if (!data)
-        return false;
-
-    static bool is_inverted = true;
     double mod = (is_inverted ? -1.0 : 1.0) * (reverse ? -1.0 : 1.0);
 
-    double *duration = (double *) data;
-    keyfr->duration = *duration;
+    keyfr->duration = duration;
+    keyfr->is_delay = false;
 
     double *knee_delta = (double *) config_get(CONF_WALK_KNEE_DELTA);
     double *hip_delta = (double *) config_get(CONF_WALK_HIP_DELTA);
@@ -187,41 +239,23 @@ bool keyfactory_strafe(Keyframe *keyfr, size_t len, void *data, bool reverse)
         }
     }
 
-    is_inverted = !is_inverted;
     return true;
-    
 }
 
-bool keyfactory_turnsegment(Keyframe *keyfr, size_t len, void *data, bool reverse)
+/*
+ A turn swings one leg at a time, in the state's order; once all four have swung, the 
+ next segment brings every hip back to centre together.
+ */
+static bool keyfactory_turnsegment(Keyframe *keyfr, size_t len, const GaitState *state, double duration, bool reverse)
 {
-    if (!data)
-        return false;
+    keyfr->duration = duration;
+    keyfr->is_delay = false;
 
-    double *duration = (double *) data;
-    keyfr->duration = *duration;
-
-    static unsigned short leg = SERVO_INDEX_FRONT_RIGHT_HIP;
-    static bool legs_complete[4];
+    const bool *legs_complete = state->turn_legs_complete;
+    unsigned short leg = state->turn_leg;
     unsigned short knee = get_knee_from_leg(leg);
     
-    bool all_complete = true;
-    for (unsigned short x = 0; x < 4; x++)
-    {
-        if (legs_complete[x] == false)
-        {
-            all_complete = false;
-            break;
-        }
-    }
-
-    if (all_complete)
-    {
-        for (unsigned short e = 0; e < 4; e++)
-        {
-            legs_complete[e] = false;
-        }
-        leg = SERVO_INDEX_FRONT_LEFT_HIP;
-    }
+    bool all_complete = keyfactory_turn_complete(state);
 
     double turn_delta = 0.9 * (reverse ? -1.0 : 1.0);
     double knee_delta = 0.4;
@@ -308,9 +342,38 @@ bool keyfactory_turnsegment(Keyframe *keyfr, size_t len, void *data, bool revers
         }
     }
 
+    return true;
+}
+
+static bool keyfactory_turn_complete(const GaitState *state)
+{
+    for (unsigned short x = 0; x < 4; x++)
+    {
+        if (state->turn_legs_complete[x] == false)
+            return false;
+    }
+
+    return true;
+}
+
+static void keyfactory_turn_advance(GaitState *state, bool reverse)
+{
+    bool *legs_complete = state->turn_legs_complete;
+    unsigned short *leg = &state->turn_leg;
+
+    bool all_complete = keyfactory_turn_complete(state);
+    if (all_complete)
+    {
+        for (unsigned short e = 0; e < 4; e++)
+        {
+            legs_complete[e] = false;
+        }
+        *leg = SERVO_INDEX_FRONT_LEFT_HIP;
+    }
+
     if (!all_complete)
     {
-        switch (leg)
+        switch (*leg)
         {
             case SERVO_INDEX_FRONT_RIGHT_HIP:
                 legs_complete[0] = true;
@@ -327,35 +390,33 @@ bool keyfactory_turnsegment(Keyframe *keyfr, size_t len, void *data, bool revers
         }
     }    
 
-    switch(leg)
+    switch(*leg)
     {
         case SERVO_INDEX_FRONT_RIGHT_HIP:
             if (reverse)
-                leg = SERVO_INDEX_FRONT_LEFT_HIP;
+                *leg = SERVO_INDEX_FRONT_LEFT_HIP;
             else
-                leg = SERVO_INDEX_BACK_RIGHT_HIP;
+                *leg = SERVO_INDEX_BACK_RIGHT_HIP;
             break;
         case SERVO_INDEX_BACK_RIGHT_HIP:
             if (reverse)
-                leg = SERVO_INDEX_FRONT_RIGHT_HIP;
+                *leg = SERVO_INDEX_FRONT_RIGHT_HIP;
             else
-                leg = SERVO_INDEX_BACK_LEFT_HIP;
+                *leg = SERVO_INDEX_BACK_LEFT_HIP;
             break;
         case SERVO_INDEX_BACK_LEFT_HIP:
             if (reverse)
-                leg = SERVO_INDEX_BACK_RIGHT_HIP;
+                *leg = SERVO_INDEX_BACK_RIGHT_HIP;
             else
-                leg = SERVO_INDEX_FRONT_LEFT_HIP;
+                *leg = SERVO_INDEX_FRONT_LEFT_HIP;
             break;
         case SERVO_INDEX_FRONT_LEFT_HIP:
             if (reverse)
-                leg = SERVO_INDEX_BACK_LEFT_HIP;
+                *leg = SERVO_INDEX_BACK_LEFT_HIP;
             else
-                leg = SERVO_INDEX_FRONT_RIGHT_HIP;
+                *leg = SERVO_INDEX_FRONT_RIGHT_HIP;
             break;
     }    
-
-    return true;
 }
 
 bool keyfactory_transition(Keyframe *keyfr, size_t len, Keyframe *src, Keyframe *dest)
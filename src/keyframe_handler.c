@@ -8,7 +8,7 @@
  Author:        Matt Mumau
  */
 
-#define _POSIX_C_SOURCE 199309L
+#define _POSIX_C_SOURCE 200112L
 
 /* System includes */
 #include <sys/prctl.h>
@@ -16,46 +16,161 @@
 #include <stdlib.h>
 #include <pthread.h>
 #include <time.h>
+#include <errno.h>
 #include <stdbool.h>
+#include <stdatomic.h>
+#include <math.h>
 
 /* Application includes */
 #include "main.h"
 #include "config_defaults.h"
 #include "config.h"
 #include "log.h"
-#include "list.h"
+#include "ring_buffer.h"
+#include "keyframe_pool.h"
+#include "keyframe_kernel.h"
+#include "motion_cache.h"
+#include "motion_library.h"
+#include "cpg_gait.h"
 #include "easing_utils.h"
 #include "utils.h"
 #include "robot.h"
 #include "keyframe_factory.h"
+#include "rt_sched.h"
+#include "timing_stats.h"
 
 /* Header */
 #include "keyframe_handler.h"
 
 static pthread_t keyhandler_thread;
+static bool thread_started = false;
 static bool running;
-static bool exec_remove_all = false;
+static bool unified_loop;
+static bool spline_mode;
+static atomic_uint clear_epoch;
 static int error;
 
-static List *keyframes = NULL;
+static RingBuffer keyframes;
+static KeyframePool keyframe_pool;
 
 static Keyframe *last_keyfr;
 static ServoPos *last_servopos;
+static AnimReal *eval_perc;
+
+// Keyframe start times are nanoseconds since the origin; the producer owns the tail of the timeline.
+static struct timespec timeline_origin;
+static atomic_llong timeline_end;
+static atomic_uint timeline_epoch;
+
+// Owned by whichever thread steps the keyframes; the pose last sent and the keyframe it came from.
+static double *last_pose;
+static bool pose_valid;
+static Keyframe *active_keyfr;
+
+static SplineSegment traj;
+static bool traj_chained;
+
+static double *blend_from;
+static double blend_time;
+static bool preempt_pending;
+static unsigned int added_epoch;
+
+// Adding thread only; where the robot's walk, strafe and turn keyframes are up to.
+static GaitState gait_state;
+
+static long long gait_start;
 
 /* Forward decs */
 static void *keyhandler_main(void *arg);
-static double keyhandler_mappos(double perc, ServoPos *servo_pos);
+static void keyhandler_tick(const struct timespec *due);
+static void keyhandler_step(const struct timespec *time, size_t len);
 static void keyhandler_exec_removeall();
-static void keyhandler_add_transition(size_t len, Keyframe *src, Keyframe *dest);
+static bool keyhandler_add_transition(size_t len, Keyframe *src, Keyframe *dest);
+static bool keyhandler_add_motion(Keyframe *keyfr, size_t len, unsigned short keyfr_type, double duration, bool reverse);
+static bool keyhandler_add_library(Keyframe *keyfr, const LibraryFrameRef *ref);
+static void keyhandler_log_full(unsigned short keyfr_type, size_t needed);
 static void keyhandler_copy_keyfr(Keyframe *dest, Keyframe *src, size_t len);
 static void keyhandler_log_keyfr(Keyframe *keyfr);
 static void keyhandler_keyfr_destroy(Keyframe *keyfr);
+static void keyhandler_keyfr_discard(Keyframe *keyfr);
 static void keyhandler_set_robot(Keyframe *keyfr, size_t len, double time);
+static void keyhandler_spline_begin(Keyframe *keyfr, size_t len);
+static void keyhandler_set_spline(size_t len, double time);
+static void keyhandler_keyfr_begin(Keyframe *keyfr, size_t len);
+static void keyhandler_keyfr_end(Keyframe *keyfr, size_t len, unsigned int epoch, long long now);
+static void keyhandler_blend(AnimReal *pos, size_t len, double time, double duration);
+static void keyhandler_save_pose(const AnimReal *pos, size_t len);
+static void keyhandler_schedule(Keyframe *keyfr);
+static void keyhandler_set_gait(const struct timespec *time, long long now, size_t len);
+static long long keyhandler_now_ns();
 static void keyhandler_resey_keyfr(Keyframe *keyfr, size_t len);
 
 void keyhandler_init()
 {
     unsigned short *servos_num = (unsigned short *) config_get(CONF_SERVOS_NUM);
+    unsigned int *queue_size = (unsigned int *) config_get(CONF_KEYFRAME_QUEUE_SIZE);
+
+    bool *easing_lut = (bool *) config_get(CONF_EASING_LUT);
+    bool *keyframe_spline = (bool *) config_get(CONF_KEYFRAME_SPLINE);
+    double *blend_time_conf = (double *) config_get(CONF_BLEND_TIME);
+
+    atomic_init(&clear_epoch, 0);
+    atomic_init(&timeline_epoch, 0);
+    atomic_init(&timeline_end, 0);
+
+    error = easing_init(*easing_lut);
+    if (error)
+        APP_ERROR("Could not build the easing lookup tables.", error);
+
+    error = ring_init(&keyframes, *queue_size);
+    if (error)
+        APP_ERROR("Could not allocate the keyframe queue.", error);
+
+    // One block per queue slot, plus the keyframe and transition being built while the last one is retired.
+    error = kfpool_init(&keyframe_pool, (size_t) *queue_size + KEYFRAME_POOL_SLACK, *servos_num);
+    if (error)
+        APP_ERROR("Could not allocate the keyframe pool.", error);
+
+    error = motcache_init(*servos_num);
+    if (error)
+        APP_ERROR("Could not allocate the motion cache.", error);
+
+    keyfactory_gait_init(&gait_state);
+    cpg_init();
+
+    // Not fatal; the built in motions work without a library, and it can be reloaded later.
+    motlib_init(*servos_num);
+
+    eval_perc = calloc(*servos_num, sizeof(AnimReal));
+    if (!eval_perc)
+        APP_ERROR("Could not allocate memory.", 1);
+
+    last_pose = calloc(*servos_num, sizeof(double));
+    blend_from = calloc(*servos_num, sizeof(double));
+    if (!last_pose || !blend_from)
+        APP_ERROR("Could not allocate memory.", 1);
+
+    pose_valid = false;
+    active_keyfr = NULL;
+
+    spline_mode = *keyframe_spline;
+    blend_time = *blend_time_conf;
+    preempt_pending = false;
+    added_epoch = 0;
+
+    if (spline_mode)
+    {
+        traj.from = calloc(*servos_num, sizeof(double));
+        traj.to = calloc(*servos_num, sizeof(double));
+        traj.m0 = calloc(*servos_num, sizeof(double));
+        traj.m1 = calloc(*servos_num, sizeof(double));
+        if (!traj.from || !traj.to || !traj.m0 || !traj.m1)
+            APP_ERROR("Could not allocate memory.", 1);
+
+        traj_chained = false;
+
+        log_event("[KYFR] Keyframes are chained through a spline trajectory.");
+    }
 
     last_keyfr = calloc(1, sizeof(Keyframe));
     if (!last_keyfr)
@@ -73,39 +188,124 @@ void keyhandler_init()
     keyhandler_print_keyfr(last_keyfr, *servos_num); 
     #endif  
 
+    bool *robot_unified_loop = (bool *) config_get(CONF_ROBOT_UNIFIED_LOOP);
+    unified_loop = *robot_unified_loop;
+
+    clock_gettime(CLOCK_MONOTONIC, &timeline_origin);
+
+    if (unified_loop)
+    {
+        robot_set_tick_hook(keyhandler_tick);
+        log_event("[KYFR] Keyframes are evaluated on the robot output tick.");
+        return;
+    }
+
     running = true;
     error = pthread_create(&keyhandler_thread, NULL, keyhandler_main, NULL);
     if (error)
         APP_ERROR("Could not initialize keyframe thread.", error);
+    thread_started = true;
+
+    rtsched_apply(keyhandler_thread, RT_THREAD_KEYFR);
 }
 
+/* Also called after an init that failed part way, so everything here must cope with what was never set up. */
 void keyhandler_halt()
 {
-    running = false;
-    pthread_join(keyhandler_thread, NULL);
+    if (unified_loop)
+        robot_set_tick_hook(NULL);
+    else if (thread_started)
+    {
+        running = false;
+        pthread_join(keyhandler_thread, NULL);
+    }
+    thread_started = false;
+
+    keyhandler_exec_removeall();
+    ring_destroy(&keyframes);
+    kfpool_destroy(&keyframe_pool);
+    motcache_destroy();
+    motlib_destroy();
+    easing_destroy();
+
+    if (eval_perc)
+        free(eval_perc);
+    eval_perc = NULL;
 
-    if (last_keyfr->servo_pos)
-        free(last_keyfr->servo_pos);
-    last_keyfr->servo_pos = NULL;
+    free(last_pose);
+    free(blend_from);
+    last_pose = blend_from = NULL;
+
+    if (spline_mode)
+    {
+        free(traj.from);
+        free(traj.to);
+        free(traj.m0);
+        free(traj.m1);
+        traj.from = traj.to = traj.m0 = traj.m1 = NULL;
+    }
 
     if (last_keyfr)
+    {
+        if (last_keyfr->servo_pos)
+            free(last_keyfr->servo_pos);
+        last_keyfr->servo_pos = NULL;
+
         free(last_keyfr);
+    }
     last_keyfr = NULL;
 }
 
-void keyhandler_add(unsigned short keyfr_type, void *data, bool reverse, bool skip_transitions)
+/*
+ The queue is single producer, single consumer; only the event thread adds and only the 
+ keyframe thread pops, so space checked here cannot shrink before the keyframe and its 
+ transition are pushed. Each keyframe is stamped with the clear epoch it was added under.
+
+ Keyframes are scheduled back to back on an absolute timeline as they are added, so time 
+ left over when one finishes carries into the next rather than being lost.
+
+ The first moving keyframe after a clear, whether from a halt or a command redirecting 
+ the motion in flight, is marked to preempt; it skips the transition, which would start 
+ from a pose the robot never reached, and instead cross-fades from wherever the robot 
+ stopped over blend_time. Queueing a keyframe stops the oscillator gait, whose start 
+ cleared the queue, so a keyframe after the gait cross-fades from it too.
+ */
+bool keyhandler_add(unsigned short keyfr_type, void *data, bool reverse, bool skip_transitions)
 {
     unsigned short *servos_num = (unsigned short *) config_get(CONF_SERVOS_NUM);
     bool *transitions_enable = (bool *) config_get(CONF_TRANSITIONS_ENABLE);
+
+    // A spline joins keyframes smoothly on its own; transition keyframes would only add a stop.
+    bool add_transition = keyfr_type != KEYFR_DELAY && *transitions_enable && !skip_transitions && !spline_mode;
+
+    unsigned int epoch = atomic_load_explicit(&clear_epoch, memory_order_acquire);
+    // A spline already leaves from the current pose after a halt, so it is never blended.
+    if (epoch != added_epoch && blend_time > 0.0 && !spline_mode)
+        preempt_pending = true;
+
+    if (preempt_pending && keyfr_type != KEYFR_DELAY)
+        add_transition = false;
+
+    size_t needed = add_transition ? 2 : 1;
+
+    if (ring_space(&keyframes) < needed)
+    {
+        keyhandler_log_full(keyfr_type, needed);
+
+        if (data)
+            free(data);
+        return false;
+    }
     
-    Keyframe *keyfr = calloc(1, sizeof(Keyframe));
+    Keyframe *keyfr = kfpool_alloc(&keyframe_pool);
     if (!keyfr)
-        APP_ERROR("Could not allocate memory.", 1);
+    {
+        keyhandler_log_full(keyfr_type, needed);
 
-    ServoPos *servo_pos = calloc(*servos_num, sizeof(ServoPos));
-    if (!servo_pos)
-        APP_ERROR("Could not allocate memory.", 1);    
-    keyfr->servo_pos = servo_pos;
+        if (data)
+            free(data);
+        return false;
+    }
 
     bool (*keyfactory_cb)(Keyframe *keyfr, size_t len, void *data, bool reverse);
     keyfactory_cb = NULL;
@@ -119,20 +319,17 @@ void keyhandler_add(unsigned short keyfr_type, void *data, bool reverse, bool sk
     if (keyfr_type == KEYFR_ELEVATE)
         keyfactory_cb = keyfactory_elevate;
 
-    if (keyfr_type == KEYFR_WALK)
-        keyfactory_cb = keyfactory_walk;
-
     if (keyfr_type == KEYFR_EXTEND)
         keyfactory_cb = keyfactory_extend;
 
-    if (keyfr_type == KEYFR_TURN)
-        keyfactory_cb = keyfactory_turnsegment;
-
-    if (keyfr_type == KEYFR_STRAFE)
-        keyfactory_cb = keyfactory_strafe;
-
     bool success = false;
-    if (keyfactory_cb != NULL)
+    if ((keyfr_type == KEYFR_WALK || keyfr_type == KEYFR_STRAFE) && data)
+        success = keyhandler_add_motion(keyfr, *servos_num, keyfr_type, *((double *) data), reverse);
+    else if (keyfr_type == KEYFR_TURN && data)
+        success = keyfactory_next(&gait_state, &gait_state, keyfr, *servos_num, keyfr_type, *((double *) data), reverse);
+    else if (keyfr_type == KEYFR_LIBRARY && data)
+        success = keyhandler_add_library(keyfr, (LibraryFrameRef *) data);
+    else if (keyfactory_cb != NULL)
         success = (*keyfactory_cb)(keyfr, *servos_num, data, reverse);
 
     if (data)
@@ -141,22 +338,41 @@ void keyhandler_add(unsigned short keyfr_type, void *data, bool reverse, bool sk
 
     if (!success)
     {
-        if (keyfr != NULL)
-            free(keyfr);
-        keyfr = NULL;
+        kfpool_discard(&keyframe_pool, keyfr);
+        return false;
+    }
 
-        if (servo_pos != NULL)
-            free(servo_pos);
-        servo_pos = NULL;
+    keyfr->epoch = epoch;
+    added_epoch = epoch;
 
-        return;
+    if (preempt_pending && !keyfr->is_delay)
+    {
+        keyfr->preempt = true;
+        preempt_pending = false;
+    }
+
+    // Poses like reset or elevate are instant and normally reached through a transition.
+    if (spline_mode && !keyfr->is_delay && keyfr->duration <= 0.0)
+    {
+        double *trans_duration = (double *) config_get(CONF_TRANSITIONS_TIME);
+        keyfr->duration = *trans_duration;
+    }
+
+    if (!keyfr->motion && !keyfr->library)
+        kfkernel_bake(keyfr, *servos_num);
+
+    // Remember, the transition should come before the keyframe... and without it the joints would jump, so neither is queued.
+    if (add_transition && !keyhandler_add_transition(*servos_num, last_keyfr, keyfr))
+    {
+        keyhandler_keyfr_discard(keyfr);
+        return false;
     }
 
-    // Remember, the transition should come before the keyframe...
-    if (keyfr_type != KEYFR_DELAY && *transitions_enable && !skip_transitions)
-        keyhandler_add_transition(*servos_num, last_keyfr, keyfr);
+    keyhandler_schedule(keyfr);
+    ring_push(&keyframes, (void *) keyfr);
 
-    list_push(&keyframes, (void *) keyfr);
+    // Only now that the keyframe is queued; a rejected add leaves the gait running.
+    cpg_stop();
 
     #ifdef PEABOT_DBG
     printf("-----ACTIVE KEYFR-----\n");
@@ -164,24 +380,107 @@ void keyhandler_add(unsigned short keyfr_type, void *data, bool reverse, bool sk
     #endif
     
     keyhandler_copy_keyfr(last_keyfr, keyfr, *servos_num);
+    return true;
+}
+
+size_t keyhandler_space()
+{
+    return ring_space(&keyframes);
 }
 
 void keyhandler_removeall()
 {
-    exec_remove_all = true;
+    atomic_fetch_add_explicit(&clear_epoch, 1, memory_order_acq_rel);
 }
 
-static void keyhandler_add_transition(size_t len, Keyframe *src, Keyframe *dest)
+/*
+ A redirect is a clear that only happens while something is still queued or playing; the 
+ step drops the old keyframes on its next tick and holds the pose it last sent, and the 
+ command's first moving keyframe, marked to preempt because the epoch moved on, cross-fades 
+ from that pose. Producer side only, so nothing can be added between the check and the clear.
+
+ The old keyframes keep their slots until the step pops them, so the redirect waits a few 
+ ticks for that; otherwise a command needing those slots would be rejected after it had 
+ already stopped the motion it was meant to replace.
+ */
+bool keyhandler_redirect()
 {
-    Keyframe *keyfr = calloc(1, sizeof(Keyframe));
-    if (!keyfr)
-        APP_ERROR("Could not allocate memory.", 1);
+    if (blend_time <= 0.0)
+        return false;
+
+    long long end = atomic_load_explicit(&timeline_end, memory_order_acquire);
+    bool current = atomic_load_explicit(&timeline_epoch, memory_order_acquire) == atomic_load_explicit(&clear_epoch, memory_order_acquire);
 
-    ServoPos *servo_pos = calloc(len, sizeof(ServoPos));
-    if (!servo_pos)
-        APP_ERROR("Could not allocate memory.", 1); 
+    if (!current || end <= keyhandler_now_ns())
+        return false;
 
-    keyfr->servo_pos = servo_pos;
+    keyhandler_removeall();
+
+    struct timespec tick = { 0, 0 };
+    utils_timespec_addns(&tick, robot_tick_ns());
+
+    for (unsigned short i = 0; i < KEYHANDLER_REDIRECT_TICKS && ring_count(&keyframes) > 0; i++)
+        nanosleep(&tick, NULL);
+
+    return true;
+}
+
+void keyhandler_completion(struct timespec *done)
+{
+    long long now = keyhandler_now_ns();
+    long long end = atomic_load_explicit(&timeline_end, memory_order_acquire);
+
+    // Anything scheduled before the last clear will never run.
+    if (atomic_load_explicit(&timeline_epoch, memory_order_acquire) != atomic_load_explicit(&clear_epoch, memory_order_acquire))
+        end = now;
+
+    *done = timeline_origin;
+    utils_timespec_addns(done, end > now ? end : now);
+}
+
+/*
+ Start keyfr where the last scheduled keyframe ends, or now if the queue has run dry or 
+ was cleared since. Producer side only.
+ */
+static void keyhandler_schedule(Keyframe *keyfr)
+{
+    long long now = keyhandler_now_ns();
+    long long end = atomic_load_explicit(&timeline_end, memory_order_relaxed);
+
+    if (keyfr->epoch != atomic_load_explicit(&timeline_epoch, memory_order_relaxed) || end < now)
+        end = now;
+
+    keyfr->start_ns = end;
+    end += (long long) llround(keyfr->duration * 1000000000.0);
+
+    atomic_store_explicit(&timeline_epoch, keyfr->epoch, memory_order_relaxed);
+    atomic_store_explicit(&timeline_end, end, memory_order_release);
+}
+
+static long long keyhandler_now_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return utils_timediff_ns(now, timeline_origin);
+}
+
+/*
+ Queue the transition from src to dest, if they do not already meet. False only when 
+ the pool had no block left for it, which is logged; the caller then drops dest too.
+ */
+static bool keyhandler_add_transition(size_t len, Keyframe *src, Keyframe *dest)
+{
+    Keyframe *keyfr = kfpool_alloc(&keyframe_pool);
+    if (!keyfr)
+    {
+        char log_msg[LOG_LINE_MAXLEN];
+        snprintf(log_msg, sizeof(log_msg), "[KYFR] Keyframe pool exhausted; dropped a transition and its keyframe. (pool: %zu)", 
+            keyframe_pool.capacity);
+        log_event(log_msg);
+
+        return false;
+    }
 
     double *trans_duration = (double *) config_get(CONF_TRANSITIONS_TIME);
     keyfr->duration = *trans_duration;    
@@ -190,31 +489,90 @@ static void keyhandler_add_transition(size_t len, Keyframe *src, Keyframe *dest)
 
     if (!success)
     {
-        if (keyfr)
-            free(keyfr);
-        keyfr = NULL;
+        kfpool_discard(&keyframe_pool, keyfr);
+        return true;
+    } 
 
-        if (servo_pos)
-            free(servo_pos);
-        servo_pos = NULL;
+    keyfr->epoch = dest->epoch;
+    kfkernel_bake(keyfr, len);
+    keyhandler_schedule(keyfr);
 
-        return;
-    } 
+    ring_push(&keyframes, (void *) keyfr);    
+    return true;
+}
+
+/*
+ Gait keyframes are looked up in the motion cache, and built and baked into it only 
+ on a miss; the queued keyframe then points at the cached positions and lanes instead 
+ of its own. With every cache entry in use it is built into its own block as before.
+ */
+static bool keyhandler_add_motion(Keyframe *keyfr, size_t len, unsigned short keyfr_type, double duration, bool reverse)
+{
+    unsigned short phase = keyfactory_gait_phase(&gait_state, keyfr_type);
+    keyfactory_advance(&gait_state, &gait_state, keyfr_type, reverse);
+
+    MotionKey key = { keyfr_type, reverse, phase, duration, config_get_version() };
+
+    bool hit;
+    MotionEntry *entry = motcache_acquire(&key, &hit);
+    if (!entry)
+        return keyfactory_gait(keyfr, len, keyfr_type, duration, reverse, phase);
+
+    if (!hit)
+    {
+        if (!keyfactory_gait(entry->keyfr, len, keyfr_type, duration, reverse, phase))
+        {
+            motcache_discard(entry);
+            return false;
+        }
+
+        kfkernel_bake(entry->keyfr, len);
+    }
+
+    keyfr->duration = entry->keyfr->duration;
+    keyfr->is_delay = false;
+    keyfr->servo_pos = entry->keyfr->servo_pos;
+    keyfr->lanes = entry->keyfr->lanes;
+    keyfr->motion = entry;
+
+    return true;
+}
+
+/* Library frames were baked when the file was loaded; the keyframe shares them and keeps that load alive. */
+static bool keyhandler_add_library(Keyframe *keyfr, const LibraryFrameRef *ref)
+{
+    if (!ref->library || ref->frame >= ref->library->frames_num)
+        return false;
+
+    Keyframe *frame = ref->library->frames[ref->frame];
 
-    list_push(&keyframes, (void *) keyfr);    
+    keyfr->duration = frame->duration;
+    keyfr->is_delay = frame->is_delay;
+    keyfr->servo_pos = frame->servo_pos;
+    keyfr->lanes = frame->lanes;
+
+    motlib_retain(ref->library);
+    keyfr->library = ref->library;
+
+    return true;
 }
 
 static void keyhandler_exec_removeall()
 {
-    Keyframe *keyfr_popped = NULL;
-    keyfr_popped = (Keyframe *) list_pop(&keyframes);
+    Keyframe *keyfr_popped = (Keyframe *) ring_pop(&keyframes);
     while (keyfr_popped != NULL)
     {
-        if (keyfr_popped)
-            free(keyfr_popped);    
-        keyfr_popped = (Keyframe *) list_pop(&keyframes);
+        keyhandler_keyfr_destroy(keyfr_popped);
+        keyfr_popped = (Keyframe *) ring_pop(&keyframes);
     }
-    keyframes = NULL;
+}
+
+static void keyhandler_log_full(unsigned short keyfr_type, size_t needed)
+{
+    char log_msg[LOG_LINE_MAXLEN];
+    snprintf(log_msg, sizeof(log_msg), "[KYFR] Keyframe queue full; dropped a type %d keyframe needing %zu of %zu free slots.", 
+        keyfr_type, needed, ring_space(&keyframes));
+    log_event(log_msg);
 }
 
 static void *keyhandler_main(void *arg)
@@ -222,53 +580,135 @@ static void *keyhandler_main(void *arg)
     prctl(PR_SET_NAME, "PEABOT_KEYFR\0", NULL, NULL, NULL);
 
     unsigned short *servos_num = (unsigned short *) config_get(CONF_SERVOS_NUM);
+    struct timespec deadline, woke;
+    int retval;
 
-    struct timespec time;
-    struct timespec last_time;
-    double next = 0.0;
-    
+    // Sleeps to absolute deadlines one robot tick apart, so it never holds the CPU from lower priority threads.
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    while (running)
+    {
+        utils_timespec_addns(&deadline, robot_tick_ns());
+
+        do
+            retval = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+        while (retval == EINTR && running);
+
+        clock_gettime(CLOCK_MONOTONIC, &woke);
+        tmstats_record(TMSTATS_KEYFR_LATENESS, utils_timediff_ns(woke, deadline));
+
+        keyhandler_step(&deadline, *servos_num);
+    }
+
+    return (void *) NULL;
+}
+
+static void keyhandler_tick(const struct timespec *due)
+{
+    unsigned short *servos_num = (unsigned short *) config_get(CONF_SERVOS_NUM);
+    keyhandler_step(due, *servos_num);
+}
+
+/*
+ Ticks rarely land on a keyframe's end, so its last evaluation is up to a tick short of 
+ its end positions; with nothing following at once, the joints would stay there. 
+ */
+static void keyhandler_keyfr_end(Keyframe *keyfr, size_t len, unsigned int epoch, long long now)
+{
+    if (keyfr->is_delay)
+        return;
+
+    Keyframe *next = (Keyframe *) ring_peek_at(&keyframes, 1);
+    if (next && next->epoch == epoch && !next->is_delay && now >= next->start_ns)
+        return;
+
+    if (keyfr != active_keyfr)
+        keyhandler_keyfr_begin(keyfr, len);
+
+    if (spline_mode)
+        keyhandler_set_spline(len, keyfr->duration);
+    else if (keyfr->servo_pos)
+        keyhandler_set_robot(keyfr, len, keyfr->duration);
+}
+
+/*
+ Advance the active keyframe to time and publish its positions, retiring any keyframes 
+ which have finished or were cleared. Runs once per output tick, either on the keyframe 
+ thread or on the robot thread, never both. Each keyframe is evaluated at time less its 
+ scheduled start; an instant keyframe still gets one evaluation, and a finished one gets 
+ a last evaluation at its end unless another keyframe takes over this tick.
+ */
+static void keyhandler_step(const struct timespec *time, size_t len)
+{
     Keyframe *keyfr;
     Keyframe *tmp_key;
-    ServoPos *servo_pos;
-    
-    clock_gettime(CLOCK_MONOTONIC, &last_time);
-    while (running)
+    unsigned int epoch;
+    double elapsed;
+
+    long long now = utils_timediff_ns(*time, timeline_origin);
+
+    if (cpg_active())
+    {
+        keyhandler_set_gait(time, now, len);
+        return;
+    }
+
+    while (true)
     {
-        clock_gettime(CLOCK_MONOTONIC, &time);
-        next += utils_timediff(time, last_time);
-        last_time = time;  
+        epoch = atomic_load_explicit(&clear_epoch, memory_order_acquire);
 
-        if (exec_remove_all)
+        keyfr = (Keyframe *) ring_peek(&keyframes);
+        if (!keyfr)
         {
-            keyhandler_exec_removeall();
-            exec_remove_all = false;
-            next = 0.0;
-            continue;
+            traj_chained = false;
+            return;
         }
 
-        if (!keyframes)
+        // Queued before the last clear; drop it without animating.
+        if (keyfr->epoch != epoch)
         {
-            next = 0.0;
-            continue;       
-        }        
+            tmp_key = (Keyframe *) ring_pop(&keyframes);
+            keyhandler_keyfr_destroy(tmp_key);
+            active_keyfr = NULL;
+            traj_chained = false;
+            continue;
+        }
 
-        keyfr = (Keyframe *) keyframes->data;
-        servo_pos = keyfr->servo_pos != NULL ? keyfr->servo_pos : NULL;        
+        elapsed = (double) (now - keyfr->start_ns) / 1000000000.0;
+        if (elapsed < 0.0)
+            return;
 
-        if (next > keyfr->duration)
+        if (elapsed > keyfr->duration && (keyfr->duration > 0.0 || keyfr == active_keyfr))
         {
-            tmp_key = (Keyframe *) list_pop(&keyframes);
+            keyhandler_keyfr_end(keyfr, len, epoch, now);
+
+            tmp_key = (Keyframe *) ring_pop(&keyframes);
             keyhandler_log_keyfr(tmp_key);  
             keyhandler_keyfr_destroy(tmp_key);
-            next = 0.0;
+            traj_chained = active_keyfr == tmp_key;
+            active_keyfr = NULL;
             continue;
-        }           
+        }
 
-        if (!keyfr->is_delay && servo_pos)
-            keyhandler_set_robot(keyfr, *servos_num, next);
-    }
+        if (keyfr != active_keyfr)
+            keyhandler_keyfr_begin(keyfr, len);
 
-    return (void *) NULL;
+        if (elapsed > keyfr->duration)
+            elapsed = keyfr->duration;
+
+        if (spline_mode)
+        {
+            if (!keyfr->is_delay)
+                keyhandler_set_spline(len, elapsed);
+
+            return;
+        }
+
+        if (!keyfr->is_delay && keyfr->servo_pos)
+            keyhandler_set_robot(keyfr, len, elapsed);
+
+        return;
+    }
 }
 
 static void keyhandler_set_robot(Keyframe *keyfr, size_t len, double time)
@@ -276,25 +716,151 @@ static void keyhandler_set_robot(Keyframe *keyfr, size_t len, double time)
     if (!keyfr || !keyfr->servo_pos)
         return;
 
-    ServoPos * servo_pos = keyfr->servo_pos;
-    double perc, pos, begin_time, end_time, adjusted_duration;
+    long long eval_start = tmstats_now();
+    AnimReal *pos = robot_frame_begin();
 
-    for (unsigned short i = 0; i < len; i++)
+    kfkernel_eval(&keyfr->lanes, time, eval_perc, pos, len);
+
+    if (keyfr->preempt && pose_valid)
+        keyhandler_blend(pos, len, time, keyfr->duration);
+
+    keyhandler_save_pose(pos, len);
+
+    robot_frame_publish();
+    tmstats_record(TMSTATS_KEYFR_EVAL, tmstats_now() - eval_start);
+}
+
+/*
+ Start the segment towards keyfr's end positions. A segment which ran to completion 
+ hands over its end point and velocity, so consecutive keyframes join with continuous 
+ velocity; after a clear or an empty queue it starts at rest from the last pose sent. 
+ The end velocity is the Catmull-Rom tangent through the next queued keyframe, or zero 
+ if there is none yet. Pads and easings are not used along a spline.
+ */
+static void keyhandler_spline_begin(Keyframe *keyfr, size_t len)
+{
+    traj.duration = keyfr->duration;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        if (traj_chained)
+        {
+            traj.from[i] = traj.to[i];
+            traj.m0[i] = traj.m1[i];
+        }
+        else
+        {
+            traj.from[i] = pose_valid || !keyfr->servo_pos ? last_pose[i] : (double) keyfr->servo_pos[i].start_pos;
+            traj.m0[i] = 0.0;
+        }
+    }
+
+    // A delay holds the pose it starts from.
+    if (keyfr->is_delay || !keyfr->servo_pos)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            traj.to[i] = traj.from[i];
+            traj.m0[i] = 0.0;
+            traj.m1[i] = 0.0;
+        }
+
+        return;
+    }
+
+    Keyframe *after = (Keyframe *) ring_peek_at(&keyframes, 1);
+    bool has_after = after && !after->is_delay && after->servo_pos && after->epoch == keyfr->epoch;
+    double span = keyfr->duration + (has_after ? after->duration : 0.0);
+
+    for (size_t i = 0; i < len; i++)
     {
-        begin_time = keyfr->duration * servo_pos[i].begin_pad;
-        end_time = keyfr->duration * servo_pos[i].end_pad;
-        adjusted_duration = keyfr->duration - begin_time - end_time;  
-        
-        perc = (time - begin_time) / adjusted_duration;
-
-        if (perc < 0.0)
-            perc = 0.0;
-        if (perc > 1.0)
-            perc = 1.0;
-
-        pos = keyhandler_mappos(perc, &servo_pos[i]);
-        robot_setservo(i, pos);
-    }    
+        traj.to[i] = (double) keyfr->servo_pos[i].end_pos;
+        traj.m1[i] = has_after && span > 0.0 ? ((double) after->servo_pos[i].end_pos - traj.from[i]) / span : 0.0;
+    }
+}
+
+static void keyhandler_set_spline(size_t len, double time)
+{
+    long long eval_start = tmstats_now();
+    AnimReal *pos = robot_frame_begin();
+
+    kfkernel_spline_eval(&traj, time, pos, len);
+    keyhandler_save_pose(pos, len);
+
+    robot_frame_publish();
+    tmstats_record(TMSTATS_KEYFR_EVAL, tmstats_now() - eval_start);
+}
+
+static void keyhandler_keyfr_begin(Keyframe *keyfr, size_t len)
+{
+    active_keyfr = keyfr;
+
+    if (spline_mode)
+        keyhandler_spline_begin(keyfr, len);
+
+    if (keyfr->preempt)
+    {
+        for (size_t i = 0; i < len; i++)
+            blend_from[i] = last_pose[i];
+    }
+}
+
+/*
+ Mix the pose the robot stopped at into the first ticks of a preempting keyframe, with 
+ a smoothstep weight so the hand-over has no velocity jump at either end. The window 
+ never outlasts the keyframe itself.
+ */
+static void keyhandler_blend(AnimReal *pos, size_t len, double time, double duration)
+{
+    double window = blend_time < duration ? blend_time : duration;
+    if (window <= 0.0 || time >= window)
+        return;
+
+    double u = time > 0.0 ? time / window : 0.0;
+    double w = u * u * (3.0 - 2.0 * u);
+
+    for (size_t i = 0; i < len; i++)
+        pos[i] = ANIM_REAL(blend_from[i] + (ANIM_DOUBLE(pos[i]) - blend_from[i]) * w);
+}
+
+/*
+ The gait drives only the legs' joints; any other joint holds the pose it was left at. 
+ Starting the gait cross-fades from that pose as a preempting keyframe would; so does a 
+ restart, even one stopped and started again between two ticks, since the oscillator 
+ then starts over from rest.
+ */
+static void keyhandler_set_gait(const struct timespec *time, long long now, size_t len)
+{
+    long long eval_start = tmstats_now();
+    AnimReal *pos = robot_frame_begin();
+
+    for (size_t i = 0; i < len; i++)
+        pos[i] = ANIM_REAL(last_pose[i]);
+
+    if (cpg_eval(time, pos, len))
+    {
+        gait_start = now;
+        active_keyfr = NULL;
+        traj_chained = false;
+
+        for (size_t i = 0; i < len; i++)
+            blend_from[i] = last_pose[i];
+    }
+
+    if (pose_valid)
+        keyhandler_blend(pos, len, (double) (now - gait_start) / 1000000000.0, blend_time);
+
+    keyhandler_save_pose(pos, len);
+
+    robot_frame_publish();
+    tmstats_record(TMSTATS_KEYFR_EVAL, tmstats_now() - eval_start);
+}
+
+static void keyhandler_save_pose(const AnimReal *pos, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+        last_pose[i] = ANIM_DOUBLE(pos[i]);
+    pose_valid = true;
 }
 
 static void keyhandler_keyfr_destroy(Keyframe *keyfr)
@@ -302,26 +868,29 @@ static void keyhandler_keyfr_destroy(Keyframe *keyfr)
     if (!keyfr)
         return;
 
-    if (keyfr->servo_pos)
-        free(keyfr->servo_pos);
-    keyfr->servo_pos = NULL; 
+    if (keyfr->motion)
+        motcache_release(keyfr->motion);
+    keyfr->motion = NULL;
+
+    if (keyfr->library)
+        motlib_release(keyfr->library);
+    keyfr->library = NULL;
 
-    free(keyfr);        
+    kfpool_free(&keyframe_pool, keyfr);
 }
 
-static double keyhandler_mappos(double perc, ServoPos *servo_pos)
+/* Adding thread; give back a keyframe which was built but never queued, with any share it holds. */
+static void keyhandler_keyfr_discard(Keyframe *keyfr)
 {
-    double diff, modifier, delta, final;
-
-    diff = servo_pos->end_pos - servo_pos->start_pos;
-    modifier = easing_calc(servo_pos->easing, perc);
-    delta = diff * modifier;    
-    final = servo_pos->start_pos + delta;
+    if (keyfr->motion)
+        motcache_release(keyfr->motion);
+    keyfr->motion = NULL;
 
-    // todo: remove
-    //printf("diff: %f, modifier: %f, delta: %f, final: %f\n", diff, modifier, delta, final);
+    if (keyfr->library)
+        motlib_release(keyfr->library);
+    keyfr->library = NULL;
 
-    return final;
+    kfpool_discard(&keyframe_pool, keyfr);
 }
 
 static void keyhandler_copy_keyfr(Keyframe *dest, Keyframe *src, size_t len)
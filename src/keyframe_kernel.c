@@ -0,0 +1,241 @@
+#ifndef KEYFRAME_KERNEL_DEF
+#define KEYFRAME_KERNEL_DEF
+
+/*
+ File:          keyframe_kernel.c
+ Description:   Implementation of keyframe baking and the per-tick evaluation kernel.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+/* System includes */
+#include <stdlib.h>
+#include <stddef.h>
+#include <errno.h>
+#include <math.h>
+
+/* Application includes */
+#include "precision.h"
+#include "keyframe_handler.h"
+#include "easing_utils.h"
+#include "timing_stats.h"
+
+/* Header */
+#include "keyframe_kernel.h"
+
+#define KFKERNEL_BENCH_KEYFRAMES 64
+#define KFKERNEL_BENCH_STEPS 100
+#define KFKERNEL_SPAN_STEPS 32767.0
+
+/* Forward decs */
+static double kfkernel_bench_rand(unsigned int *seed);
+static void kfkernel_bench_fill(Keyframe *keyfr, size_t len, unsigned int *seed);
+static double kfkernel_reference(ServoPos *servo_pos, double duration, double time);
+
+/*
+ A joint moves between begin = duration * begin_pad and duration - duration * end_pad, 
+ so its progress is (time - begin) / span. That is folded into a scale and an offset 
+ here, once per keyframe. A joint with no span left jumps straight to its end position.
+
+ A span is never shorter than 1/KFKERNEL_SPAN_STEPS of the keyframe or of a second, 
+ whichever is longer, so scale, offset and time * scale all stay within the Q16.16 
+ range; that is far under a tick, and every build bakes the same way.
+ */
+void kfkernel_bake(Keyframe *keyfr, size_t len)
+{
+    KeyframeLanes *lanes = &keyfr->lanes;
+    ServoPos *servo_pos = keyfr->servo_pos;
+    double begin, span;
+    double min_span = (keyfr->duration > 1.0 ? keyfr->duration : 1.0) / KFKERNEL_SPAN_STEPS;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        begin = keyfr->duration * servo_pos[i].begin_pad;
+        span = keyfr->duration - begin - keyfr->duration * servo_pos[i].end_pad;
+
+        if (span > 0.0 && span < min_span)
+            span = min_span;
+
+        if (span > 0.0)
+        {
+            lanes->scale[i] = ANIM_REAL(1.0 / span);
+            lanes->offset[i] = ANIM_REAL(-begin / span);
+        }
+        else
+        {
+            lanes->scale[i] = ANIM_REAL(0.0);
+            lanes->offset[i] = ANIM_ONE;
+        }
+
+        lanes->start[i] = ANIM_REAL(servo_pos[i].start_pos);
+        lanes->delta[i] = ANIM_REAL(servo_pos[i].end_pos - servo_pos[i].start_pos);
+        lanes->easing[i] = servo_pos[i].easing;
+    }
+}
+
+/*
+ The first and last passes are plain element-wise loops over restrict-qualified lanes, 
+ which the compiler vectorizes; only the easing pass between them is per joint, and 
+ linear joints skip it. Everything is in the build's AnimReal; the easing functions 
+ themselves run in AHFloat, which is single precision outside the double build.
+ */
+void kfkernel_eval(const KeyframeLanes *lanes, double time, AnimReal *restrict perc, AnimReal *restrict pos, size_t len)
+{
+    const AnimReal *restrict scale = lanes->scale;
+    const AnimReal *restrict offset = lanes->offset;
+    const AnimReal *restrict start = lanes->start;
+    const AnimReal *restrict delta = lanes->delta;
+    const unsigned short *restrict easing = lanes->easing;
+    AnimReal t = ANIM_REAL(time);
+    AnimReal p;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        p = ANIM_MUL(t, scale[i]) + offset[i];
+        p = p < 0 ? 0 : p;
+        perc[i] = p > ANIM_ONE ? ANIM_ONE : p;
+    }
+
+    for (size_t i = 0; i < len; i++)
+        if (easing[i] != EASE_LINEAR)
+            perc[i] = ANIM_REAL(easing_calc(easing[i], (AHFloat) ANIM_DOUBLE(perc[i])));
+
+    for (size_t i = 0; i < len; i++)
+        pos[i] = start[i] + ANIM_MUL(delta[i], perc[i]);
+}
+
+/*
+ Cubic Hermite; the velocities are per second, so they are scaled by the segment's 
+ duration into the segment's own 0 to 1 parameter.
+ */
+void kfkernel_spline_eval(const SplineSegment *segment, double time, AnimReal *restrict pos, size_t len)
+{
+    double u = segment->duration > 0.0 ? time / segment->duration : 1.0;
+    u = u < 0.0 ? 0.0 : u;
+    u = u > 1.0 ? 1.0 : u;
+
+    double u2 = u * u;
+    double u3 = u2 * u;
+    double h00 = 2.0 * u3 - 3.0 * u2 + 1.0;
+    double h10 = (u3 - 2.0 * u2 + u) * segment->duration;
+    double h01 = -2.0 * u3 + 3.0 * u2;
+    double h11 = (u3 - u2) * segment->duration;
+
+    const double *restrict from = segment->from;
+    const double *restrict to = segment->to;
+    const double *restrict m0 = segment->m0;
+    const double *restrict m1 = segment->m1;
+
+    for (size_t i = 0; i < len; i++)
+        pos[i] = ANIM_REAL(h00 * from[i] + h10 * m0[i] + h01 * to[i] + h11 * m1[i]);
+}
+
+/*
+ The reference is the original per-servo formula in double. Its easing still runs in 
+ AHFloat, so this measures what the lanes, the kernel and the frame format lose, not 
+ the easing functions' own rounding. The seed is fixed so runs compare across builds.
+ */
+int kfkernel_bench(size_t len, unsigned int rounds, KernelBench *bench)
+{
+    Keyframe keyfr;
+    ServoPos *servo_pos = calloc(len, sizeof(ServoPos));
+    AnimReal *lanes = calloc(6 * len, sizeof(AnimReal));
+    unsigned short *easing = calloc(len, sizeof(unsigned short));
+
+    if (!servo_pos || !lanes || !easing)
+    {
+        free(servo_pos);
+        free(lanes);
+        free(easing);
+        return ENOMEM;
+    }
+
+    keyfr.servo_pos = servo_pos;
+    keyfr.lanes.scale = lanes;
+    keyfr.lanes.offset = lanes + len;
+    keyfr.lanes.start = lanes + 2 * len;
+    keyfr.lanes.delta = lanes + 3 * len;
+    keyfr.lanes.easing = easing;
+
+    AnimReal *perc = lanes + 4 * len;
+    AnimReal *pos = lanes + 5 * len;
+    unsigned int seed = 1;
+    unsigned long samples = 0;
+    double err, err_sum = 0.0;
+
+    bench->max_err = 0.0;
+
+    for (unsigned int k = 0; k < KFKERNEL_BENCH_KEYFRAMES; k++)
+    {
+        kfkernel_bench_fill(&keyfr, len, &seed);
+
+        for (unsigned int step = 0; step <= KFKERNEL_BENCH_STEPS; step++)
+        {
+            double time = keyfr.duration * step / KFKERNEL_BENCH_STEPS;
+            kfkernel_eval(&keyfr.lanes, time, perc, pos, len);
+
+            for (size_t i = 0; i < len; i++)
+            {
+                err = fabs(ANIM_DOUBLE(pos[i]) - kfkernel_reference(&servo_pos[i], keyfr.duration, time));
+                err_sum += err;
+                samples++;
+
+                if (err > bench->max_err)
+                    bench->max_err = err;
+            }
+        }
+    }
+
+    bench->mean_err = err_sum / samples;
+
+    long long start = tmstats_now();
+    for (unsigned int r = 0; r < rounds; r++)
+        kfkernel_eval(&keyfr.lanes, keyfr.duration * (r % KFKERNEL_BENCH_STEPS) / KFKERNEL_BENCH_STEPS, perc, pos, len);
+    long long elapsed = tmstats_now() - start;
+
+    bench->evals = rounds;
+    bench->eval_ns = rounds ? (double) elapsed / rounds : 0.0;
+
+    free(servo_pos);
+    free(lanes);
+    free(easing);
+
+    return 0;
+}
+
+static void kfkernel_bench_fill(Keyframe *keyfr, size_t len, unsigned int *seed)
+{
+    keyfr->duration = 0.1 + 2.0 * kfkernel_bench_rand(seed);
+
+    for (size_t i = 0; i < len; i++)
+    {
+        keyfr->servo_pos[i].easing = (unsigned short) (kfkernel_bench_rand(seed) * EASE_NUM) % EASE_NUM;
+        keyfr->servo_pos[i].start_pos = 2.0 * kfkernel_bench_rand(seed) - 1.0;
+        keyfr->servo_pos[i].end_pos = 2.0 * kfkernel_bench_rand(seed) - 1.0;
+        keyfr->servo_pos[i].begin_pad = 0.4 * kfkernel_bench_rand(seed);
+        keyfr->servo_pos[i].end_pad = 0.4 * kfkernel_bench_rand(seed);
+    }
+
+    kfkernel_bake(keyfr, len);
+}
+
+static double kfkernel_reference(ServoPos *servo_pos, double duration, double time)
+{
+    double begin = duration * servo_pos->begin_pad;
+    double span = duration - begin - duration * servo_pos->end_pad;
+    double perc = (time - begin) / span;
+
+    perc = perc < 0.0 ? 0.0 : perc;
+    perc = perc > 1.0 ? 1.0 : perc;
+
+    double eased = easing_calc(servo_pos->easing, (AHFloat) perc);
+    return servo_pos->start_pos + (servo_pos->end_pos - servo_pos->start_pos) * eased;
+}
+
+static double kfkernel_bench_rand(unsigned int *seed)
+{
+    *seed = *seed * 1103515245U + 12345U;
+    return (double) ((*seed >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+#endif
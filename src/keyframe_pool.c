@@ -0,0 +1,136 @@
+#ifndef KEYFRAME_POOL_DEF
+#define KEYFRAME_POOL_DEF
+
+/*
+ File:          keyframe_pool.c
+ Description:   Implementation of the fixed keyframe pool.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+/* System includes */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/* Application includes */
+#include "ring_buffer.h"
+#include "keyframe_handler.h"
+
+/* Header */
+#include "keyframe_pool.h"
+
+/* Forward decs */
+static size_t kfpool_align(size_t size);
+static size_t kfpool_lanes_size(size_t servos_num);
+
+/*
+ Every block is the keyframe header padded out to a cache line, followed by its 
+ servo positions and then each of its lanes on its own line, so one keyframe never 
+ shares a line with its neighbours and every lane starts aligned for the kernel. The 
+ whole slab is allocated once here and blocks only move through the free ring, which 
+ is single producer, single consumer: one thread retires keyframes and one allocates 
+ them. A block the allocating thread gives back itself goes to the spare slot instead.
+ */
+int kfpool_init(KeyframePool *pool, size_t capacity, size_t servos_num)
+{
+    if (!capacity)
+        return EINVAL;
+
+    pool->block_size = kfpool_align(sizeof(Keyframe)) + kfpool_align(servos_num * sizeof(ServoPos)) + kfpool_lanes_size(servos_num);
+    pool->capacity = capacity;
+    pool->servos_num = servos_num;
+    pool->spare = NULL;
+
+    pool->slab = aligned_alloc(KEYFRAME_POOL_ALIGN, pool->block_size * capacity);
+    if (!pool->slab)
+        return ENOMEM;
+    memset(pool->slab, 0, pool->block_size * capacity);
+
+    int error = ring_init(&pool->free_blocks, capacity);
+    if (error)
+    {
+        free(pool->slab);
+        pool->slab = NULL;
+        return error;
+    }
+
+    for (size_t i = 0; i < capacity; i++)
+        ring_push(&pool->free_blocks, (void *) (pool->slab + i * pool->block_size));
+
+    return 0;
+}
+
+void kfpool_destroy(KeyframePool *pool)
+{
+    ring_destroy(&pool->free_blocks);
+
+    if (pool->slab)
+        free(pool->slab);
+    pool->slab = NULL;
+    pool->capacity = 0;
+}
+
+Keyframe *kfpool_alloc(KeyframePool *pool)
+{
+    unsigned char *block = (unsigned char *) pool->spare;
+    pool->spare = NULL;
+
+    if (!block)
+        block = (unsigned char *) ring_pop(&pool->free_blocks);
+    if (!block)
+        return NULL;
+
+    size_t lane_size = kfpool_align(pool->servos_num * sizeof(AnimReal));
+    size_t at = kfpool_align(sizeof(Keyframe));
+
+    Keyframe *keyfr = (Keyframe *) block;
+    ServoPos *servo_pos = (ServoPos *) (block + at);
+    at += kfpool_align(pool->servos_num * sizeof(ServoPos));
+
+    memset(keyfr, 0, sizeof(Keyframe));
+    memset(servo_pos, 0, pool->servos_num * sizeof(ServoPos));
+    keyfr->servo_pos = servo_pos;
+
+    keyfr->lanes.scale = (AnimReal *) (block + at);
+    keyfr->lanes.offset = (AnimReal *) (block + at + lane_size);
+    keyfr->lanes.start = (AnimReal *) (block + at + 2 * lane_size);
+    keyfr->lanes.delta = (AnimReal *) (block + at + 3 * lane_size);
+    keyfr->lanes.easing = (unsigned short *) (block + at + 4 * lane_size);
+
+    return keyfr;
+}
+
+void kfpool_discard(KeyframePool *pool, Keyframe *keyfr)
+{
+    if (!keyfr)
+        return;
+
+    // Only one block is ever discarded between allocations, so the slot is always free here.
+    pool->spare = keyfr;
+}
+
+void kfpool_free(KeyframePool *pool, Keyframe *keyfr)
+{
+    if (!keyfr)
+        return;
+
+    ring_push(&pool->free_blocks, (void *) keyfr);
+}
+
+size_t kfpool_available(KeyframePool *pool)
+{
+    return ring_count(&pool->free_blocks) + (pool->spare ? 1 : 0);
+}
+
+static size_t kfpool_lanes_size(size_t servos_num)
+{
+    return 4 * kfpool_align(servos_num * sizeof(AnimReal)) + kfpool_align(servos_num * sizeof(unsigned short));
+}
+
+static size_t kfpool_align(size_t size)
+{
+    return (size + KEYFRAME_POOL_ALIGN - 1) & ~((size_t) KEYFRAME_POOL_ALIGN - 1);
+}
+
+#endif
@@ -0,0 +1,238 @@
+#ifndef LEG_IK_DEF
+#define LEG_IK_DEF
+
+/*
+ File:          leg_ik.c
+ Description:   Implementation of the two link leg inverse kinematics.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+/* System includes */
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <math.h>
+
+/* Application includes */
+#include "config_defaults.h"
+#include "config.h"
+#include "timing_stats.h"
+#include "math_defs.h"
+
+/* Header */
+#include "leg_ik.h"
+
+/* A built grid and the leg config it was built from. */
+typedef struct LegIkGrid {
+    double femur;
+    double tibia;
+    double range;
+    double knee_zero;
+    double reach;
+    LegJoints joints[LEGIK_GRID_SIZE][LEGIK_GRID_SIZE];
+} LegIkGrid;
+
+/* Forward decs */
+static double legik_clamp(double val, double min, double max);
+static void legik_bench_point(unsigned long i, unsigned int samples, double min_dist, double max_dist, double *x, double *z);
+
+// Lookups read whichever grid is current; builds fill the other one and swap it in.
+static LegIkGrid grids[2];
+static _Atomic(LegIkGrid *) current_grid = NULL;
+static pthread_mutex_t build_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ Law of cosines on the triangle hip, knee, foot. The knee's interior angle gives its
+ bend; the hip is the foot's direction from straight down plus the femur's angle off
+ that line.
+ */
+bool legik_solve(double x, double z, LegJoints *joints)
+{
+    double *femur = (double *) config_get(CONF_LEG_FEMUR_LENGTH);
+    double *tibia = (double *) config_get(CONF_LEG_TIBIA_LENGTH);
+    double *range = (double *) config_get(CONF_LEG_JOINT_RANGE);
+    double *knee_zero = (double *) config_get(CONF_LEG_KNEE_ZERO);
+
+    double l1 = *femur;
+    double l2 = *tibia;
+    double dist = sqrt(x * x + z * z);
+    double min_dist = fabs(l1 - l2);
+    double max_dist = l1 + l2;
+
+    bool reachable = dist >= min_dist && dist <= max_dist;
+    double solve_dist = legik_clamp(dist, min_dist, max_dist);
+
+    // Straight down is as good a direction as any for a foot at the hip itself.
+    double dir = dist > 0.0 ? atan2(x, z) : 0.0;
+
+    double cos_knee = solve_dist > 0.0 ? (l1 * l1 + l2 * l2 - solve_dist * solve_dist) / (2.0 * l1 * l2) : -1.0;
+    double cos_hip = solve_dist > 0.0 ? (l1 * l1 + solve_dist * solve_dist - l2 * l2) / (2.0 * l1 * solve_dist) : 1.0;
+
+    double bend = M_PI - acos(legik_clamp(cos_knee, -1.0, 1.0));
+    double hip = dir + acos(legik_clamp(cos_hip, -1.0, 1.0));
+
+    double scale = *range > 0.0 ? 1.0 / *range : 0.0;
+    joints->hip = legik_clamp(hip * scale, -1.0, 1.0);
+    joints->knee = legik_clamp((bend - *knee_zero) * scale, -1.0, 1.0);
+
+    return reachable;
+}
+
+/*
+ Bilinear between the cell's corners. The joint angles are smooth in the foot position 
+ over most of the reach and the error there is tiny; it peaks where a joint hits its 
+ end stop or the leg is nearly folded, where the direct solution has a kink. Never 
+ builds; before the first build it solves directly.
+ */
+void legik_lookup(double x, double z, LegJoints *joints)
+{
+    const LegIkGrid *grid = atomic_load_explicit(&current_grid, memory_order_acquire);
+    if (!grid)
+    {
+        legik_solve(x, z, joints);
+        return;
+    }
+
+    double step = 2.0 * grid->reach / (LEGIK_GRID_SIZE - 1);
+    double fx = legik_clamp((x + grid->reach) / step, 0.0, LEGIK_GRID_SIZE - 1);
+    double fz = legik_clamp(z * 2.0 / step, 0.0, LEGIK_GRID_SIZE - 1);
+
+    unsigned short ix = (unsigned short) fx;
+    unsigned short iz = (unsigned short) fz;
+    ix = ix > LEGIK_GRID_SIZE - 2 ? LEGIK_GRID_SIZE - 2 : ix;
+    iz = iz > LEGIK_GRID_SIZE - 2 ? LEGIK_GRID_SIZE - 2 : iz;
+
+    double tx = fx - ix;
+    double tz = fz - iz;
+
+    const LegJoints *a = &grid->joints[iz][ix];
+    const LegJoints *b = &grid->joints[iz][ix + 1];
+    const LegJoints *c = &grid->joints[iz + 1][ix];
+    const LegJoints *d = &grid->joints[iz + 1][ix + 1];
+
+    double top, bottom;
+
+    top = a->hip + (b->hip - a->hip) * tx;
+    bottom = c->hip + (d->hip - c->hip) * tx;
+    joints->hip = top + (bottom - top) * tz;
+
+    top = a->knee + (b->knee - a->knee) * tx;
+    bottom = c->knee + (d->knee - c->knee) * tx;
+    joints->knee = top + (bottom - top) * tz;
+}
+
+/*
+ x spans -reach to reach, and z 0 to reach, so the cells are twice as fine in z. A 
+ build only writes the grid that is not current, so a lookup would have to last through 
+ two leg config changes to see one half written.
+ */
+void legik_build()
+{
+    double *femur = (double *) config_get(CONF_LEG_FEMUR_LENGTH);
+    double *tibia = (double *) config_get(CONF_LEG_TIBIA_LENGTH);
+    double *range = (double *) config_get(CONF_LEG_JOINT_RANGE);
+    double *knee_zero = (double *) config_get(CONF_LEG_KNEE_ZERO);
+
+    pthread_mutex_lock(&build_lock);
+
+    LegIkGrid *current = atomic_load_explicit(&current_grid, memory_order_relaxed);
+    if (current && current->femur == *femur && current->tibia == *tibia && 
+        current->range == *range && current->knee_zero == *knee_zero)
+    {
+        pthread_mutex_unlock(&build_lock);
+        return;
+    }
+
+    LegIkGrid *grid = current == &grids[0] ? &grids[1] : &grids[0];
+    grid->femur = *femur;
+    grid->tibia = *tibia;
+    grid->range = *range;
+    grid->knee_zero = *knee_zero;
+    grid->reach = *femur + *tibia > 0.0 ? *femur + *tibia : 1.0;
+
+    double step = 2.0 * grid->reach / (LEGIK_GRID_SIZE - 1);
+
+    for (unsigned short iz = 0; iz < LEGIK_GRID_SIZE; iz++)
+        for (unsigned short ix = 0; ix < LEGIK_GRID_SIZE; ix++)
+            legik_solve(ix * step - grid->reach, iz * step / 2.0, &grid->joints[iz][ix]);
+
+    atomic_store_explicit(&current_grid, grid, memory_order_release);
+    pthread_mutex_unlock(&build_lock);
+}
+
+/*
+ Samples the annulus the foot can reach, inset by one grid cell at either edge,
+ below the hip. Outside that the grid only ever returns clamped positions.
+ */
+void legik_bench(unsigned int samples, LegIkBench *bench)
+{
+    double *femur = (double *) config_get(CONF_LEG_FEMUR_LENGTH);
+    double *tibia = (double *) config_get(CONF_LEG_TIBIA_LENGTH);
+
+    samples = samples < 2 ? 2 : samples;
+    legik_build();
+
+    const LegIkGrid *grid = atomic_load_explicit(&current_grid, memory_order_acquire);
+    double cell = 2.0 * grid->reach / (LEGIK_GRID_SIZE - 1);
+    double min_dist = fabs(*femur - *tibia) + cell;
+    double max_dist = *femur + *tibia - cell;
+
+    LegJoints direct, looked_up;
+    double x, z, err, err_sum = 0.0;
+    volatile double sink = 0.0;
+    unsigned long count = (unsigned long) samples * samples;
+    long long start, solve_ns, lookup_ns;
+
+    start = tmstats_now();
+    for (unsigned long i = 0; i < count; i++)
+    {
+        legik_bench_point(i, samples, min_dist, max_dist, &x, &z);
+        legik_solve(x, z, &direct);
+        sink += direct.hip;
+    }
+    solve_ns = tmstats_now() - start;
+
+    start = tmstats_now();
+    for (unsigned long i = 0; i < count; i++)
+    {
+        legik_bench_point(i, samples, min_dist, max_dist, &x, &z);
+        legik_lookup(x, z, &looked_up);
+        sink += looked_up.hip;
+    }
+    lookup_ns = tmstats_now() - start;
+
+    bench->max_err = 0.0;
+    for (unsigned long i = 0; i < count; i++)
+    {
+        legik_bench_point(i, samples, min_dist, max_dist, &x, &z);
+        legik_solve(x, z, &direct);
+        legik_lookup(x, z, &looked_up);
+
+        err = fmax(fabs(direct.hip - looked_up.hip), fabs(direct.knee - looked_up.knee));
+        bench->max_err = fmax(bench->max_err, err);
+        err_sum += err;
+    }
+
+    bench->samples = count;
+    bench->mean_err = err_sum / count;
+    bench->solve_ns = (double) solve_ns / count;
+    bench->lookup_ns = (double) lookup_ns / count;
+}
+
+/* The i-th of samples^2 points, spread evenly over distance and over the half circle below the hip. */
+static void legik_bench_point(unsigned long i, unsigned int samples, double min_dist, double max_dist, double *x, double *z)
+{
+    double dist = min_dist + (max_dist - min_dist) * (i / samples) / (samples - 1);
+    double angle = -M_PI_2 + M_PI * (i % samples) / (samples - 1);
+
+    *x = dist * sin(angle);
+    *z = dist * cos(angle);
+}
+
+static double legik_clamp(double val, double min, double max)
+{
+    return val < min ? min : (val > max ? max : val);
+}
+
+#endif
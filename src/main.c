@@ -20,7 +20,9 @@
 #include <stdbool.h>
 
 /* Raspberry Pi includes */
+#ifndef PEABOT_HOST
 #include <wiringPi.h>
+#endif
 
 /* Application includes */
 #include "config.h"
@@ -32,6 +34,7 @@
 #include "robot.h"
 #include "http_server.h"
 #include "usd_sensor.h"
+#include "rt_sched.h"
 
 /* Header */
 #include "main.h"
@@ -65,6 +68,9 @@ void app_error(const char *file, unsigned int lineno, const char *msg, unsigned
     snprintf(err_msg, sizeof(err_msg), "[ERROR!] %s [f:%s,l:%d,e:%d]", msg, file, lineno, error_code);
     log_event(err_msg);   
     app_exit(error_code);
+
+    // The caller cannot carry on with what failed, and the halts above have freed what it would use.
+    exit(error_code);
 }
 
 /*
@@ -87,7 +93,9 @@ int main(int argc, char *argv[])
     log_init();
     signal(SIGINT, signal_handler);
     console_h("Peabot Server: " APP_VERSION); 
+    #ifndef PEABOT_HOST
     wiringPiSetup();
+    #endif
 
     usd_sensor_init();
     robot_init();
@@ -96,6 +104,9 @@ int main(int argc, char *argv[])
     prompt_init();
     http_init();
 
+    rtsched_lock_memory();
+    rtsched_report();
+
     log_event("[MAIN] Peabot server initialized.");
 
     while (running) 
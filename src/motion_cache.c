@@ -0,0 +1,146 @@
+#ifndef MOTION_CACHE_DEF
+#define MOTION_CACHE_DEF
+
+/*
+ File:          motion_cache.c
+ Description:   Implementation of the gait keyframe cache.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+/* System includes */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/* Application includes */
+#include "keyframe_handler.h"
+#include "keyframe_pool.h"
+
+/* Header */
+#include "motion_cache.h"
+
+/* Forward decs */
+static bool motcache_key_matches(const MotionKey *a, const MotionKey *b);
+
+static MotionEntry entries[MOTION_CACHE_SIZE];
+static KeyframePool entry_pool;
+static unsigned long use_count = 0;
+static MotionCacheStats cache_stats;
+
+/*
+ Entry storage comes from a pool of its own, taken in full here and never returned 
+ until the cache is destroyed.
+ */
+int motcache_init(size_t servos_num)
+{
+    int error = kfpool_init(&entry_pool, MOTION_CACHE_SIZE, servos_num);
+    if (error)
+        return error;
+
+    for (unsigned short i = 0; i < MOTION_CACHE_SIZE; i++)
+    {
+        entries[i].valid = false;
+        entries[i].last_used = 0;
+        atomic_init(&entries[i].refs, 0);
+        entries[i].keyfr = kfpool_alloc(&entry_pool);
+    }
+
+    return 0;
+}
+
+void motcache_destroy()
+{
+    for (unsigned short i = 0; i < MOTION_CACHE_SIZE; i++)
+    {
+        entries[i].valid = false;
+        entries[i].keyfr = NULL;
+    }
+
+    kfpool_destroy(&entry_pool);
+}
+
+/*
+ Only the adding thread takes references and rebuilds entries. An entry is only 
+ rebuilt once its count has dropped to zero, and the acquire on that load pairs 
+ with the release in motcache_release, so no queued keyframe can still be reading 
+ it. Entries built under an older config version are never hit again, and age out 
+ as the least recently used.
+ */
+MotionEntry *motcache_acquire(const MotionKey *key, bool *hit)
+{
+    MotionEntry *victim = NULL;
+
+    use_count++;
+
+    for (unsigned short i = 0; i < MOTION_CACHE_SIZE; i++)
+    {
+        MotionEntry *entry = &entries[i];
+
+        if (entry->valid && motcache_key_matches(&entry->key, key))
+        {
+            atomic_fetch_add_explicit(&entry->refs, 1, memory_order_relaxed);
+            entry->last_used = use_count;
+            cache_stats.hits++;
+
+            *hit = true;
+            return entry;
+        }
+
+        if (atomic_load_explicit(&entry->refs, memory_order_acquire) != 0)
+            continue;
+
+        // Prefer an unused entry, then the least recently used one.
+        if (!entry->valid)
+        {
+            if (!victim || victim->valid)
+                victim = entry;
+            continue;
+        }
+
+        if (!victim || (victim->valid && entry->last_used < victim->last_used))
+            victim = entry;
+    }
+
+    if (!victim)
+    {
+        cache_stats.bypassed++;
+        return NULL;
+    }
+
+    victim->key = *key;
+    victim->valid = true;
+    victim->last_used = use_count;
+    atomic_store_explicit(&victim->refs, 1, memory_order_relaxed);
+    cache_stats.misses++;
+
+    *hit = false;
+    return victim;
+}
+
+void motcache_discard(MotionEntry *entry)
+{
+    entry->valid = false;
+    motcache_release(entry);
+}
+
+void motcache_release(MotionEntry *entry)
+{
+    atomic_fetch_sub_explicit(&entry->refs, 1, memory_order_release);
+}
+
+void motcache_get_stats(MotionCacheStats *stats)
+{
+    *stats = cache_stats;
+}
+
+static bool motcache_key_matches(const MotionKey *a, const MotionKey *b)
+{
+    return a->type == b->type && 
+        a->reverse == b->reverse && 
+        a->phase == b->phase && 
+        a->duration == b->duration && 
+        a->version == b->version;
+}
+
+#endif
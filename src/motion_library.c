@@ -0,0 +1,454 @@
+#ifndef MOTION_LIBRARY_DEF
+#define MOTION_LIBRARY_DEF
+
+/*
+ File:          motion_library.c
+ Description:   Implementation of the JSON motion library.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+/* System includes */
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <errno.h>
+
+/* Libraries */
+#include "cJSON.h"
+
+/* Application includes */
+#include "main.h"
+#include "config.h"
+#include "config_defaults.h"
+#include "log.h"
+#include "easing_utils.h"
+#include "keyframe_handler.h"
+#include "keyframe_pool.h"
+#include "keyframe_kernel.h"
+
+/* Header */
+#include "motion_library.h"
+
+#define MOTION_LIBRARY_MAXSIZE (1024 * 1024)
+
+/* Forward decs */
+static MotionLibrary *motlib_load(const char *path, size_t servos_num);
+static char *motlib_read(const char *path);
+static bool motlib_validate(const cJSON *motions_jp, size_t servos_num, size_t *frames_num);
+static bool motlib_validate_frame(const cJSON *frame_jp, size_t servos_num, const char *name, int f);
+static bool motlib_number(const cJSON *parent_jp, const char *key, double min, double max, double fallback, double *val);
+static void motlib_fill_frame(Keyframe *keyfr, const cJSON *frame_jp, size_t servos_num);
+static void motlib_free(MotionLibrary *library);
+static void motlib_free_dead();
+static void motlib_log_error(const char *name, int frame, const char *msg);
+
+static pthread_mutex_t library_lock = PTHREAD_MUTEX_INITIALIZER;
+static MotionLibrary *current = NULL;
+static _Atomic(MotionLibrary *) dead = NULL;
+static unsigned int generation = 0;
+static size_t library_servos_num;
+
+int motlib_init(size_t servos_num)
+{
+    library_servos_num = servos_num;
+    return motlib_reload();
+}
+
+void motlib_destroy()
+{
+    pthread_mutex_lock(&library_lock);
+    MotionLibrary *old = current;
+    current = NULL;
+    pthread_mutex_unlock(&library_lock);
+
+    if (old)
+        motlib_release(old);
+
+    motlib_free_dead();
+}
+
+/*
+ The new library is built and validated in full before the swap, so a bad edit to
+ the file never leaves a half loaded one behind. Keyframes already queued from the
+ old library keep it alive until they are retired.
+ */
+int motlib_reload()
+{
+    const char *path = (const char *) config_get(CONF_MOTION_LIBRARY);
+
+    motlib_free_dead();
+
+    MotionLibrary *library = motlib_load(path, library_servos_num);
+    if (!library)
+        return EINVAL;
+
+    pthread_mutex_lock(&library_lock);
+    MotionLibrary *old = current;
+    library->generation = ++generation;
+    current = library;
+    pthread_mutex_unlock(&library_lock);
+
+    if (old)
+        motlib_release(old);
+
+    char log_msg[LOG_LINE_MAXLEN];
+    snprintf(log_msg, sizeof(log_msg), "[MLIB] Loaded %zu motions with %zu frames from %s. (generation: %u)",
+        library->motions_num, library->frames_num, path, library->generation);
+    log_event(log_msg);
+
+    return 0;
+}
+
+MotionLibrary *motlib_acquire()
+{
+    motlib_free_dead();
+
+    pthread_mutex_lock(&library_lock);
+    MotionLibrary *library = current;
+    if (library)
+        atomic_fetch_add_explicit(&library->refs, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&library_lock);
+
+    return library;
+}
+
+void motlib_retain(MotionLibrary *library)
+{
+    atomic_fetch_add_explicit(&library->refs, 1, memory_order_relaxed);
+}
+
+void motlib_release(MotionLibrary *library)
+{
+    if (!library)
+        return;
+
+    if (atomic_fetch_sub_explicit(&library->refs, 1, memory_order_acq_rel) != 1)
+        return;
+
+    // Pushed onto the dead list without a lock; the list is only ever taken whole.
+    MotionLibrary *head = atomic_load_explicit(&dead, memory_order_relaxed);
+    do
+        library->next_dead = head;
+    while (!atomic_compare_exchange_weak_explicit(&dead, &head, library, memory_order_release, memory_order_relaxed));
+}
+
+const LibraryMotion *motlib_find(const MotionLibrary *library, const char *name)
+{
+    if (!library || !name)
+        return NULL;
+
+    for (size_t m = 0; m < library->motions_num; m++)
+        if (strcmp(library->motions[m].name, name) == 0)
+            return &library->motions[m];
+
+    return NULL;
+}
+
+/*
+ The file is parsed once here and never again; every frame is built and baked into
+ the library's own pool, and queued keyframes point straight at those. Running out 
+ of memory is logged like a bad file, since a reload must leave the old library live.
+ */
+static MotionLibrary *motlib_load(const char *path, size_t servos_num)
+{
+    char *text = motlib_read(path);
+    if (!text)
+        return NULL;
+
+    cJSON *root_jp = cJSON_Parse(text);
+    free(text);
+
+    if (!root_jp)
+    {
+        motlib_log_error(NULL, -1, "the file is not valid JSON");
+        return NULL;
+    }
+
+    cJSON *motions_jp = cJSON_GetObjectItem(root_jp, "motions");
+    size_t frames_num = 0;
+
+    if (!motlib_validate(motions_jp, servos_num, &frames_num))
+    {
+        cJSON_Delete(root_jp);
+        return NULL;
+    }
+
+    MotionLibrary *library = calloc(1, sizeof(MotionLibrary));
+    if (!library)
+    {
+        cJSON_Delete(root_jp);
+        motlib_log_error(NULL, -1, "out of memory");
+        return NULL;
+    }
+
+    atomic_init(&library->refs, 1);
+    library->motions_num = (size_t) cJSON_GetArraySize(motions_jp);
+    library->frames_num = frames_num;
+    library->motions = calloc(library->motions_num, sizeof(LibraryMotion));
+    library->frames = calloc(frames_num, sizeof(Keyframe *));
+
+    // A pool which failed to initialize is left empty, and freeing it does nothing.
+    if (!library->motions || !library->frames || kfpool_init(&library->pool, frames_num, servos_num))
+    {
+        motlib_free(library);
+        cJSON_Delete(root_jp);
+        motlib_log_error(NULL, -1, "out of memory");
+        return NULL;
+    }
+
+    size_t frame = 0;
+    for (size_t m = 0; m < library->motions_num; m++)
+    {
+        cJSON *motion_jp = cJSON_GetArrayItem(motions_jp, (int) m);
+        cJSON *frames_jp = cJSON_GetObjectItem(motion_jp, "frames");
+        LibraryMotion *motion = &library->motions[m];
+
+        snprintf(motion->name, sizeof(motion->name), "%s", cJSON_GetObjectItem(motion_jp, "name")->valuestring);
+        motion->first = frame;
+        motion->frames_num = (size_t) cJSON_GetArraySize(frames_jp);
+
+        for (size_t f = 0; f < motion->frames_num; f++, frame++)
+        {
+            Keyframe *keyfr = kfpool_alloc(&library->pool);
+            motlib_fill_frame(keyfr, cJSON_GetArrayItem(frames_jp, (int) f), servos_num);
+            kfkernel_bake(keyfr, servos_num);
+            library->frames[frame] = keyfr;
+        }
+    }
+
+    cJSON_Delete(root_jp);
+    return library;
+}
+
+static char *motlib_read(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        motlib_log_error(NULL, -1, "the file could not be opened");
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    if (size <= 0 || size > MOTION_LIBRARY_MAXSIZE)
+    {
+        fclose(file);
+        motlib_log_error(NULL, -1, "the file is empty or too large");
+        return NULL;
+    }
+
+    char *text = calloc((size_t) size + 1, 1);
+    if (!text)
+    {
+        fclose(file);
+        motlib_log_error(NULL, -1, "out of memory");
+        return NULL;
+    }
+
+    size_t read = fread(text, 1, (size_t) size, file);
+    fclose(file);
+
+    if (read != (size_t) size)
+    {
+        free(text);
+        motlib_log_error(NULL, -1, "the file could not be read");
+        return NULL;
+    }
+
+    return text;
+}
+
+/* Everything motlib_load relies on is checked here, before anything is allocated. */
+static bool motlib_validate(const cJSON *motions_jp, size_t servos_num, size_t *frames_num)
+{
+    if (!motions_jp || !cJSON_IsArray(motions_jp))
+    {
+        motlib_log_error(NULL, -1, "\"motions\" must be an array");
+        return false;
+    }
+
+    int motions_num = cJSON_GetArraySize(motions_jp);
+    *frames_num = 0;
+
+    for (int m = 0; m < motions_num; m++)
+    {
+        cJSON *motion_jp = cJSON_GetArrayItem(motions_jp, m);
+        cJSON *name_jp = cJSON_GetObjectItem(motion_jp, "name");
+        if (!name_jp || !cJSON_IsString(name_jp) || !name_jp->valuestring[0] || strlen(name_jp->valuestring) >= MOTION_NAME_MAXLEN)
+        {
+            motlib_log_error(NULL, -1, "every motion needs a name, shorter than 32 characters");
+            return false;
+        }
+
+        const char *name = name_jp->valuestring;
+        for (int o = 0; o < m; o++)
+        {
+            if (strcmp(cJSON_GetObjectItem(cJSON_GetArrayItem(motions_jp, o), "name")->valuestring, name) == 0)
+            {
+                motlib_log_error(name, -1, "the name is used twice");
+                return false;
+            }
+        }
+
+        cJSON *frames_jp = cJSON_GetObjectItem(motion_jp, "frames");
+        if (!frames_jp || !cJSON_IsArray(frames_jp) || cJSON_GetArraySize(frames_jp) < 1)
+        {
+            motlib_log_error(name, -1, "\"frames\" must be an array of at least one frame");
+            return false;
+        }
+
+        int frames = cJSON_GetArraySize(frames_jp);
+        for (int f = 0; f < frames; f++)
+            if (!motlib_validate_frame(cJSON_GetArrayItem(frames_jp, f), servos_num, name, f))
+                return false;
+
+        *frames_num += (size_t) frames;
+    }
+
+    if (!*frames_num)
+    {
+        motlib_log_error(NULL, -1, "the library has no frames");
+        return false;
+    }
+
+    return true;
+}
+
+static bool motlib_validate_frame(const cJSON *frame_jp, size_t servos_num, const char *name, int f)
+{
+    double val;
+
+    if (!motlib_number(frame_jp, "duration", 0.0, 3600.0, -1.0, &val) || val < 0.0)
+    {
+        motlib_log_error(name, f, "\"duration\" must be 0 to 3600 seconds");
+        return false;
+    }
+
+    cJSON *delay_jp = cJSON_GetObjectItem(frame_jp, "delay");
+    if (delay_jp && !cJSON_IsBool(delay_jp))
+    {
+        motlib_log_error(name, f, "\"delay\" must be true or false");
+        return false;
+    }
+
+    if (delay_jp && cJSON_IsTrue(delay_jp))
+        return true;
+
+    cJSON *joints_jp = cJSON_GetObjectItem(frame_jp, "joints");
+    if (!joints_jp || !cJSON_IsArray(joints_jp) || (size_t) cJSON_GetArraySize(joints_jp) != servos_num)
+    {
+        motlib_log_error(name, f, "\"joints\" needs one entry per servo");
+        return false;
+    }
+
+    for (size_t i = 0; i < servos_num; i++)
+    {
+        cJSON *joint_jp = cJSON_GetArrayItem(joints_jp, (int) i);
+        double begin_pad, end_pad;
+
+        bool valid = cJSON_IsObject(joint_jp) &&
+            motlib_number(joint_jp, "easing", 0.0, EASE_NUM - 1, EASE_LINEAR, &val) && val == (double) (int) val &&
+            motlib_number(joint_jp, "start", -1.0, 1.0, 0.0, &val) &&
+            motlib_number(joint_jp, "end", -1.0, 1.0, 0.0, &val) &&
+            motlib_number(joint_jp, "begin_pad", 0.0, 1.0, 0.0, &begin_pad) &&
+            motlib_number(joint_jp, "end_pad", 0.0, 1.0, 0.0, &end_pad) &&
+            begin_pad + end_pad <= 1.0;
+
+        if (!valid)
+        {
+            motlib_log_error(name, f, "a joint's easing, position or pads out of range");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* A missing key gives fallback; one that is present must be a number from min to max. */
+static bool motlib_number(const cJSON *parent_jp, const char *key, double min, double max, double fallback, double *val)
+{
+    cJSON *number_jp = cJSON_GetObjectItem(parent_jp, key);
+    if (!number_jp)
+    {
+        *val = fallback;
+        return true;
+    }
+
+    if (!cJSON_IsNumber(number_jp))
+        return false;
+
+    *val = number_jp->valuedouble;
+    return *val >= min && *val <= max;
+}
+
+static void motlib_fill_frame(Keyframe *keyfr, const cJSON *frame_jp, size_t servos_num)
+{
+    double val;
+
+    motlib_number(frame_jp, "duration", 0.0, 3600.0, 0.0, &keyfr->duration);
+
+    cJSON *delay_jp = cJSON_GetObjectItem(frame_jp, "delay");
+    keyfr->is_delay = delay_jp && cJSON_IsTrue(delay_jp);
+    if (keyfr->is_delay)
+        return;
+
+    cJSON *joints_jp = cJSON_GetObjectItem(frame_jp, "joints");
+    for (size_t i = 0; i < servos_num; i++)
+    {
+        cJSON *joint_jp = cJSON_GetArrayItem(joints_jp, (int) i);
+        ServoPos *servo_pos = &keyfr->servo_pos[i];
+
+        motlib_number(joint_jp, "easing", 0.0, EASE_NUM - 1, EASE_LINEAR, &val);
+        servo_pos->easing = (unsigned short) (int) val;
+
+        motlib_number(joint_jp, "start", -1.0, 1.0, 0.0, &servo_pos->start_pos);
+        motlib_number(joint_jp, "end", -1.0, 1.0, 0.0, &servo_pos->end_pos);
+        motlib_number(joint_jp, "begin_pad", 0.0, 1.0, 0.0, &servo_pos->begin_pad);
+        motlib_number(joint_jp, "end_pad", 0.0, 1.0, 0.0, &servo_pos->end_pad);
+    }
+}
+
+static void motlib_free_dead()
+{
+    MotionLibrary *library = atomic_exchange_explicit(&dead, NULL, memory_order_acquire);
+    MotionLibrary *next;
+
+    while (library)
+    {
+        next = library->next_dead;
+        motlib_free(library);
+        library = next;
+    }
+}
+
+static void motlib_free(MotionLibrary *library)
+{
+    kfpool_destroy(&library->pool);
+    free(library->motions);
+    free(library->frames);
+    free(library);
+}
+
+static void motlib_log_error(const char *name, int frame, const char *msg)
+{
+    const char *path = (const char *) config_get(CONF_MOTION_LIBRARY);
+    char log_msg[LOG_LINE_MAXLEN];
+
+    if (name && frame >= 0)
+        snprintf(log_msg, sizeof(log_msg), "[MLIB] Not loading %s: motion %s, frame %d: %s.", path, name, frame, msg);
+    else if (name)
+        snprintf(log_msg, sizeof(log_msg), "[MLIB] Not loading %s: motion %s: %s.", path, name, msg);
+    else
+        snprintf(log_msg, sizeof(log_msg), "[MLIB] Not loading %s: %s.", path, msg);
+
+    log_event(log_msg);
+}
+
+#endif
@@ -54,6 +54,8 @@ const char *mvcdata_get_modelstr(MVCData *mvc_data)
             return "USD";
         case MODEL_POSITION:
             return "POSITION";
+        case MODEL_TIMING:
+            return "TIMING";
     }
 
     return "INVALID";
@@ -79,6 +81,10 @@ const char *mvcdata_get_controllerstr(MVCData *mvc_data)
             return "HALT";
         case CONTROLLER_STRAFE:
             return "STRAFE";
+        case CONTROLLER_GAIT:
+            return "GAIT";
+        case CONTROLLER_MOTION:
+            return "MOTION";
     }
 
     return "INVALID";
@@ -95,6 +101,9 @@ static int mvcdata_get_model(char *model_str)
     if (strcmp(model_str, "position") == 0)
         return MODEL_POSITION;
 
+    if (strcmp(model_str, "timing") == 0)
+        return MODEL_TIMING;
+
     return MODEL_NONE;
 }
 
@@ -124,6 +133,12 @@ static int mvcdata_get_controller(char *controller_str)
     if (strcmp(controller_str, "strafe") == 0)
         return CONTROLLER_STRAFE;
 
+    if (strcmp(controller_str, "gait") == 0)
+        return CONTROLLER_GAIT;
+
+    if (strcmp(controller_str, "motion") == 0)
+        return CONTROLLER_MOTION;
+
     return CONTROLLER_NONE;
 }
 
@@ -0,0 +1,216 @@
+#ifndef PCA9685_I2C_DEF
+#define PCA9685_I2C_DEF
+
+/*
+ File:          pca9685_i2c.c
+ Description:   Implementation of direct PCA-9685 access through the i2c-dev interface.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+/* System includes */
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+/* Header */
+#include "pca9685_i2c.h"
+
+/* PCA-9685 registers */
+#define PCA9685_MODE1 0x00
+#define PCA9685_MODE2 0x01
+#define PCA9685_LED0_ON_L 0x06
+#define PCA9685_ALL_LED_ON_L 0xFA
+#define PCA9685_PRESCALE 0xFE
+
+/* MODE1 bits */
+#define PCA9685_MODE1_RESTART 0x80
+#define PCA9685_MODE1_AI 0x20
+#define PCA9685_MODE1_SLEEP 0x10
+#define PCA9685_MODE1_ALLCALL 0x01
+
+/* Bit 4 of the _H registers forces a channel fully on or off. */
+#define PCA9685_FULL 0x10
+
+/* Forward decs */
+static int pcai2c_transfer(PCA9685Dev *dev, unsigned char *buffer, unsigned short len);
+static int pcai2c_write_reg(PCA9685Dev *dev, unsigned char reg, unsigned char val);
+static int pcai2c_read_reg(PCA9685Dev *dev, unsigned char reg, unsigned char *val);
+static void pcai2c_fill_channel(unsigned char *regs, unsigned short count);
+
+int pcai2c_open(PCA9685Dev *dev, unsigned short bus, unsigned short address, unsigned int hertz)
+{
+    char path[32];
+    snprintf(path, sizeof(path), "/dev/i2c-%d", bus);
+
+    dev->address = address;
+    dev->fd = open(path, O_RDWR);
+    if (dev->fd < 0)
+        return errno;
+
+    int error = pcai2c_write_reg(dev, PCA9685_MODE1, PCA9685_MODE1_AI | PCA9685_MODE1_ALLCALL);
+    if (!error)
+        error = pcai2c_set_freq(dev, hertz);
+
+    if (error)
+        pcai2c_close(dev);
+
+    return error;
+}
+
+int pcai2c_set_freq(PCA9685Dev *dev, unsigned int hertz)
+{
+    if (hertz == 0)
+        return EINVAL;
+
+    unsigned char prescale = pcai2c_prescale(hertz);
+    unsigned char mode1;
+    int error = pcai2c_read_reg(dev, PCA9685_MODE1, &mode1);
+    if (error)
+        return error;
+
+    mode1 &= ~PCA9685_MODE1_RESTART;
+
+    error = pcai2c_write_reg(dev, PCA9685_MODE1, mode1 | PCA9685_MODE1_SLEEP);
+    if (!error)
+        error = pcai2c_write_reg(dev, PCA9685_PRESCALE, prescale);
+    if (!error)
+        error = pcai2c_write_reg(dev, PCA9685_MODE1, mode1 & ~PCA9685_MODE1_SLEEP);
+    if (error)
+        return error;
+
+    // The oscillator needs 500us to stabilize after leaving sleep.
+    struct timespec wait = { 0, 500000 };
+    nanosleep(&wait, NULL);
+
+    error = pcai2c_write_reg(dev, PCA9685_MODE1, (mode1 & ~PCA9685_MODE1_SLEEP) | PCA9685_MODE1_RESTART | PCA9685_MODE1_AI);
+    clock_gettime(CLOCK_MONOTONIC, &dev->restarted);
+
+    return error;
+}
+
+unsigned char pcai2c_prescale(unsigned int hertz)
+{
+    if (hertz == 0)
+        return 255;
+
+    long prescale = lround(PCA9685_OSC_HERTZ / (PCA9685_COUNT_MAX * (double) hertz)) - 1;
+    if (prescale < 3)
+        prescale = 3;
+    if (prescale > 255)
+        prescale = 255;
+
+    return (unsigned char) prescale;
+}
+
+long long pcai2c_period_ns(unsigned int hertz)
+{
+    double period = PCA9685_COUNT_MAX * (pcai2c_prescale(hertz) + 1.0) / PCA9685_OSC_HERTZ;
+    return llround(period * 1000000000.0);
+}
+
+int pcai2c_write(PCA9685Dev *dev, unsigned short first_channel, const unsigned short *counts, unsigned short num)
+{
+    if (first_channel + num > PCA9685_CHANNELS || num == 0)
+        return EINVAL;
+
+    unsigned char buffer[1 + PCA9685_CHANNELS * 4];
+    buffer[0] = PCA9685_LED0_ON_L + 4 * first_channel;
+
+    for (unsigned short i = 0; i < num; i++)
+        pcai2c_fill_channel(&buffer[1 + i * 4], counts[i]);
+
+    return pcai2c_transfer(dev, buffer, 1 + num * 4);
+}
+
+int pcai2c_reset(PCA9685Dev *dev)
+{
+    unsigned char buffer[5];
+    buffer[0] = PCA9685_ALL_LED_ON_L;
+    pcai2c_fill_channel(&buffer[1], 0);
+
+    return pcai2c_transfer(dev, buffer, sizeof(buffer));
+}
+
+void pcai2c_close(PCA9685Dev *dev)
+{
+    if (dev->fd >= 0)
+        close(dev->fd);
+    dev->fd = -1;
+}
+
+/*
+ Mirrors wiringPi's pwmWrite(); a count of 0 turns the channel fully off, and a 
+ count of 4096 or more turns it fully on.
+ */
+static void pcai2c_fill_channel(unsigned char *regs, unsigned short count)
+{
+    memset(regs, 0, 4);
+
+    if (count >= PCA9685_COUNT_MAX)
+        regs[1] = PCA9685_FULL;
+    else if (count == 0)
+        regs[3] = PCA9685_FULL;
+    else
+    {
+        regs[2] = count & 0xFF;
+        regs[3] = (count >> 8) & 0x0F;
+    }
+}
+
+static int pcai2c_transfer(PCA9685Dev *dev, unsigned char *buffer, unsigned short len)
+{
+    struct i2c_msg msg;
+    msg.addr = dev->address;
+    msg.flags = 0;
+    msg.len = len;
+    msg.buf = buffer;
+
+    struct i2c_rdwr_ioctl_data data;
+    data.msgs = &msg;
+    data.nmsgs = 1;
+
+    if (ioctl(dev->fd, I2C_RDWR, &data) < 0)
+        return errno;
+
+    return 0;
+}
+
+static int pcai2c_write_reg(PCA9685Dev *dev, unsigned char reg, unsigned char val)
+{
+    unsigned char buffer[2] = { reg, val };
+    return pcai2c_transfer(dev, buffer, sizeof(buffer));
+}
+
+static int pcai2c_read_reg(PCA9685Dev *dev, unsigned char reg, unsigned char *val)
+{
+    struct i2c_msg msgs[2];
+    msgs[0].addr = dev->address;
+    msgs[0].flags = 0;
+    msgs[0].len = 1;
+    msgs[0].buf = &reg;
+    msgs[1].addr = dev->address;
+    msgs[1].flags = I2C_M_RD;
+    msgs[1].len = 1;
+    msgs[1].buf = val;
+
+    struct i2c_rdwr_ioctl_data data;
+    data.msgs = msgs;
+    data.nmsgs = 2;
+
+    if (ioctl(dev->fd, I2C_RDWR, &data) < 0)
+        return errno;
+
+    return 0;
+}
+
+#endif
@@ -135,6 +135,33 @@ static void prompt_handle_cmd(const char *stdin_str, size_t len)
     if (str_equals(cmd, "strafe"))
         cmd_callback = promptcmd_strafe;
 
+    if (str_equals(cmd, "gait"))
+        cmd_callback = promptcmd_gait;
+
+    if (str_equals(cmd, "motion"))
+        cmd_callback = promptcmd_motion;
+
+    if (str_equals(cmd, "motion_reload"))
+        cmd_callback = promptcmd_motion_reload;
+
+    if (str_equals(cmd, "stats"))
+        cmd_callback = promptcmd_stats;
+
+    if (str_equals(cmd, "sim_dump"))
+        cmd_callback = promptcmd_sim_dump;
+
+    if (str_equals(cmd, "timing"))
+        cmd_callback = promptcmd_timing;
+
+    if (str_equals(cmd, "easing_bench"))
+        cmd_callback = promptcmd_easing_bench;
+
+    if (str_equals(cmd, "precision_bench"))
+        cmd_callback = promptcmd_precision_bench;
+
+    if (str_equals(cmd, "ik_bench"))
+        cmd_callback = promptcmd_ik_bench;
+
     if (cmd_callback == NULL)
     {
         console_error("Unknown command.");
@@ -8,9 +8,12 @@
  Author:        Matt Mumau
  */
 
+#define _POSIX_C_SOURCE 199309L
+
 /* System includes */ 
 #include <stdlib.h>
 #include <stdio.h>
+#include <time.h>
 
 /* Application includes */
 #include "config_defaults.h"
@@ -20,6 +23,18 @@
 #include "console.h"
 #include "events.h"
 #include "string_utils.h"
+#include "robot.h"
+#include "servo_driver.h"
+#include "driver_sim.h"
+#include "timing_stats.h"
+#include "easing_utils.h"
+#include "keyframe_kernel.h"
+#include "precision.h"
+#include "motion_cache.h"
+#include "keyframe_handler.h"
+#include "leg_ik.h"
+#include "motion_library.h"
+#include "utils.h"
 
 /* Header */
 #include "prompt_commands.h"
@@ -169,6 +184,235 @@ void promptcmd_strafe(char *args[], int arg_num)
     promptcmd_log_cmd(log_msg);        
 }
 
+void promptcmd_gait(char *args[], int arg_num)
+{
+    bool valid = promptcmd_check_args("gait [forward] [lateral] [yaw] [step_height]", 4, arg_num);
+    if (!valid)
+        return;
+
+    EventGaitData gait_data;
+    gait_data.forward = (double) atof(args[0]);
+    gait_data.lateral = (double) atof(args[1]);
+    gait_data.yaw = (double) atof(args[2]);
+    gait_data.step_height = (double) atof(args[3]);
+
+    event_add(EVENT_GAIT, (void *) &gait_data);
+
+    char log_msg[LOG_LINE_MAXLEN];
+    snprintf(log_msg, sizeof(log_msg), "Added gait event. (forward: %f, lateral: %f, yaw: %f, step_height: %f)", 
+        gait_data.forward, gait_data.lateral, gait_data.yaw, gait_data.step_height);
+    promptcmd_log_cmd(log_msg);
+}
+
+void promptcmd_motion(char *args[], int arg_num)
+{
+    bool valid = promptcmd_check_args("motion [name] [cycles]", 2, arg_num);
+    if (!valid)
+        return;
+
+    EventMotionData motion_data;
+    snprintf(motion_data.name, sizeof(motion_data.name), "%s", args[0]);
+    motion_data.cycles = (unsigned short) atoi(args[1]);
+
+    event_add(EVENT_MOTION, (void *) &motion_data);
+
+    char log_msg[LOG_LINE_MAXLEN];
+    snprintf(log_msg, sizeof(log_msg), "Added motion event. (name: %s, cycles: %d)", motion_data.name, motion_data.cycles);
+    promptcmd_log_cmd(log_msg);
+}
+
+void promptcmd_motion_reload(char *args[], int arg_num)
+{
+    int error = motlib_reload();
+    if (error)
+    {
+        console_error("Could not reload the motion library; see the log. The previous one is still in use.");
+        return;
+    }
+
+    MotionLibrary *library = motlib_acquire();
+    printf("[Motions] Loaded %zu motions with %zu frames. (generation: %u)\n", library->motions_num, library->frames_num, library->generation);
+    for (size_t m = 0; m < library->motions_num; m++)
+        printf("[Motions] %s: %zu frames\n", library->motions[m].name, library->motions[m].frames_num);
+    motlib_release(library);
+}
+
+void promptcmd_stats(char *args[], int arg_num)
+{
+    RobotTickStats tick_stats;
+    robot_get_tickstats(&tick_stats);
+
+    RobotWriteStats write_stats;
+    robot_get_writestats(&write_stats);
+
+    double saved = 0.0;
+    if (write_stats.frame_channels)
+        saved = 100.0 * (1.0 - (double) write_stats.channel_writes / (double) write_stats.frame_channels);
+
+    printf("[Stats] ticks: %lu, overruns: %lu, skipped: %lu, write errors: %lu\n", 
+        tick_stats.ticks, tick_stats.overruns, tick_stats.skipped, tick_stats.write_errors);
+    printf("[Stats] transfers: %lu, idle ticks: %lu, full refreshes: %lu\n", 
+        write_stats.transfers, write_stats.idle_ticks, write_stats.full_refreshes);
+    printf("[Stats] channel writes: %lu of %lu (%.1f%% saved)\n", 
+        write_stats.channel_writes, write_stats.frame_channels, saved);
+
+    MotionCacheStats cache_stats;
+    motcache_get_stats(&cache_stats);
+    printf("[Stats] motion cache hits: %lu, misses: %lu, bypassed: %lu\n", 
+        cache_stats.hits, cache_stats.misses, cache_stats.bypassed);
+
+    struct timespec now, done;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    keyhandler_completion(&done);
+    printf("[Stats] keyframe slots free: %zu, queue done in: %.3f s\n", keyhandler_space(), utils_timediff(done, now));
+}
+
+void promptcmd_timing(char *args[], int arg_num)
+{
+    if (arg_num > 0 && str_equals(args[0], "reset"))
+    {
+        tmstats_reset();
+        console_print("[Timing] Histograms cleared.");
+        return;
+    }
+
+    TimingSummary summary;
+    RobotTickStats tick_stats;
+    robot_get_tickstats(&tick_stats);
+
+    for (unsigned short i = 0; i < TMSTATS_NUM; i++)
+    {
+        tmstats_get(i, &summary);
+        printf("[Timing] %-15s n: %-9llu mean: %9.1f us, p50: %9.1f us, p99: %9.1f us, max: %9.1f us\n", 
+            tmstats_stage_name(i), summary.count, summary.mean, summary.p50, summary.p99, summary.max);
+    }
+
+    printf("[Timing] overruns: %lu of %lu ticks, %lu deadlines skipped\n", 
+        tick_stats.overruns, tick_stats.ticks, tick_stats.skipped);
+}
+
+/*
+ Sweeps every easing over the same inputs through each path. Building the tables here 
+ does not switch the keyframe handler over to them; only easing_lut does that.
+ */
+void promptcmd_easing_bench(char *args[], int arg_num)
+{
+    unsigned int rounds = arg_num > 0 ? (unsigned int) atoi(args[0]) : 20000;
+    if (!rounds)
+        rounds = 20000;
+
+    int error = easing_lut_build();
+    if (error)
+    {
+        console_error("Could not build the easing lookup tables.");
+        return;
+    }
+
+    volatile double sink = 0.0;
+    unsigned long calls = (unsigned long) rounds * EASE_NUM;
+    long long start, direct_ns, lut_ns;
+
+    start = tmstats_now();
+    for (unsigned int r = 0; r < rounds; r++)
+        for (unsigned short type = 0; type < EASE_NUM; type++)
+            sink += easing_calc_direct(type, (double) (r % 1000) / 1000.0);
+    direct_ns = tmstats_now() - start;
+
+    start = tmstats_now();
+    for (unsigned int r = 0; r < rounds; r++)
+        for (unsigned short type = 0; type < EASE_NUM; type++)
+            sink += easing_calc_lut(type, (double) (r % 1000) / 1000.0);
+    lut_ns = tmstats_now() - start;
+
+    double max_err = 0.0;
+    unsigned short max_type = 0;
+    unsigned short direct_num = 0;
+    for (unsigned short type = 0; type < EASE_NUM; type++)
+    {
+        if (easing_lut_maxerr(type) > EASING_LUT_MAXERR)
+        {
+            direct_num++;
+            continue;
+        }
+
+        if (easing_lut_maxerr(type) > max_err)
+        {
+            max_err = easing_lut_maxerr(type);
+            max_type = type;
+        }
+    }
+
+    printf("[Easing] direct: %.1f ns/call, lookup table: %.1f ns/call (%lu calls each)\n", 
+        (double) direct_ns / calls, (double) lut_ns / calls, calls);
+    printf("[Easing] %d segment tables, worst error %.2e (easing %d), %d easings over %.0e stay direct\n", 
+        EASING_LUT_SIZE, max_err, max_type, direct_num, EASING_LUT_MAXERR);
+}
+
+void promptcmd_precision_bench(char *args[], int arg_num)
+{
+    unsigned short *servos_num = (unsigned short *) config_get(CONF_SERVOS_NUM);
+    unsigned int rounds = arg_num > 0 ? (unsigned int) atoi(args[0]) : 100000;
+    if (!rounds)
+        rounds = 100000;
+
+    KernelBench bench;
+    int error = kfkernel_bench(*servos_num, rounds, &bench);
+    if (error)
+    {
+        console_error("Could not allocate memory.");
+        return;
+    }
+
+    // One Q15 step is the finest change the output mapping can see.
+    printf("[Precision] %s: max error %.2e (%.2f Q15 steps), mean error %.2e, against double\n", 
+        PRECISION_NAME, bench.max_err, bench.max_err * 32768.0, bench.mean_err);
+    printf("[Precision] %s: %.1f ns per %d joint evaluation (%lu evaluations)\n", 
+        PRECISION_NAME, bench.eval_ns, *servos_num, bench.evals);
+}
+
+/* Rebuilds the grid from the current config, so it also picks up changed leg lengths. */
+void promptcmd_ik_bench(char *args[], int arg_num)
+{
+    unsigned int samples = arg_num > 0 ? (unsigned int) atoi(args[0]) : 200;
+    if (!samples)
+        samples = 200;
+
+    LegIkBench bench;
+    legik_bench(samples, &bench);
+
+    printf("[IK] grid %dx%d: max error %.2e, mean error %.2e, against the direct solution (%lu foot positions)\n", 
+        LEGIK_GRID_SIZE, LEGIK_GRID_SIZE, bench.max_err, bench.mean_err, bench.samples);
+    printf("[IK] direct: %.1f ns per leg, grid: %.1f ns per leg\n", bench.solve_ns, bench.lookup_ns);
+}
+
+void promptcmd_sim_dump(char *args[], int arg_num)
+{
+    bool valid = promptcmd_check_args("sim_dump [file]", 1, arg_num);
+    if (!valid)
+        return;
+
+    unsigned short *servo_driver = (unsigned short *) config_get(CONF_SERVO_DRIVER);
+    if (*servo_driver != SERVO_DRIVER_SIM)
+    {
+        console_error("The simulated servo driver is not in use.");
+        return;
+    }
+
+    FILE *file = fopen(args[0], "w");
+    if (!file)
+    {
+        console_error("Could not open file.");
+        return;
+    }
+
+    size_t lines = drvsim_dump(file);
+    fclose(file);
+
+    char cns_msg[CONSOLE_LINE_LEN];
+    snprintf(cns_msg, sizeof(cns_msg), "[SIM] Wrote %zu of %lu servo writes.", lines, drvsim_get_write_count());
+    console_print(cns_msg);
+}
+
 static void promptcmd_log_cmd(const char *msg)
 {
     bool *log_prompt_commands = (bool *) config_get(CONF_LOG_PROMPT_COMMANDS);
@@ -283,6 +527,41 @@ void promptcmd_cfg_get(char *args[], int arg_num)
         return;
     }      
 
+    if (str_equals(var_name, "pca_9685_burst"))
+    {
+        bool *val = (bool *) config_get(CONF_PCA_9685_BURST);
+        printf("[Config] pca_9685_burst: %s\n", *val ? "true" : "false");
+        return;
+    }
+
+    if (str_equals(var_name, "pca_9685_i2c_bus"))
+    {
+        unsigned short *val = (unsigned short *) config_get(CONF_PCA_9685_I2C_BUS);
+        printf("[Config] pca_9685_i2c_bus: %i\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "pca_9685_address"))
+    {
+        unsigned short *val = (unsigned short *) config_get(CONF_PCA_9685_ADDRESS);
+        printf("[Config] pca_9685_address: 0x%x\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "pca_9685_limits_hertz"))
+    {
+        unsigned int *val = (unsigned int *) config_get(CONF_PCA_9685_LIMITS_HERTZ);
+        printf("[Config] pca_9685_limits_hertz: %i\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "servo_driver"))
+    {
+        unsigned short *val = (unsigned short *) config_get(CONF_SERVO_DRIVER);
+        printf("[Config] servo_driver: %s\n", srvdrv_type_to_str(*val));
+        return;
+    }
+
     if (str_equals(var_name, "servos_num"))
     {
         unsigned short *val = (unsigned short *) config_get(CONF_SERVOS_NUM);
@@ -297,6 +576,34 @@ void promptcmd_cfg_get(char *args[], int arg_num)
         return;
     }    
 
+    if (str_equals(var_name, "robot_refresh_ticks"))
+    {
+        unsigned short *val = (unsigned short *) config_get(CONF_ROBOT_REFRESH_TICKS);
+        printf("[Config] robot_refresh_ticks: %i\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "robot_pwm_sync"))
+    {
+        bool *val = (bool *) config_get(CONF_ROBOT_PWM_SYNC);
+        printf("[Config] robot_pwm_sync: %s\n", *val ? "true" : "false");
+        return;
+    }
+
+    if (str_equals(var_name, "robot_pwm_lead"))
+    {
+        double *val = (double *) config_get(CONF_ROBOT_PWM_LEAD);
+        printf("[Config] robot_pwm_lead: %f\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "robot_unified_loop"))
+    {
+        bool *val = (bool *) config_get(CONF_ROBOT_UNIFIED_LOOP);
+        printf("[Config] robot_unified_loop: %s\n", *val ? "true" : "false");
+        return;
+    }
+
     if (str_equals(var_name, "transitions_enable"))
     {
         bool *val = (bool *) config_get(CONF_TRANSITIONS_ENABLE);
@@ -311,6 +618,139 @@ void promptcmd_cfg_get(char *args[], int arg_num)
         return;
     }             
 
+    if (str_equals(var_name, "keyframe_queue_size"))
+    {
+        unsigned int *val = (unsigned int *) config_get(CONF_KEYFRAME_QUEUE_SIZE);
+        printf("[Config] keyframe_queue_size: %i\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "easing_lut"))
+    {
+        bool *val = (bool *) config_get(CONF_EASING_LUT);
+        printf("[Config] easing_lut: %s\n", *val ? "true" : "false");
+        return;
+    }
+
+    if (str_equals(var_name, "keyframe_spline"))
+    {
+        bool *val = (bool *) config_get(CONF_KEYFRAME_SPLINE);
+        printf("[Config] keyframe_spline: %s\n", *val ? "true" : "false");
+        return;
+    }
+
+    if (str_equals(var_name, "blend_time"))
+    {
+        double *val = (double *) config_get(CONF_BLEND_TIME);
+        printf("[Config] blend_time: %f\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "cpg_frequency"))
+    {
+        double *val = (double *) config_get(CONF_CPG_FREQUENCY);
+        printf("[Config] cpg_frequency: %f\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "cpg_smoothing"))
+    {
+        double *val = (double *) config_get(CONF_CPG_SMOOTHING);
+        printf("[Config] cpg_smoothing: %f\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "leg_femur_length"))
+    {
+        double *val = (double *) config_get(CONF_LEG_FEMUR_LENGTH);
+        printf("[Config] leg_femur_length: %f\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "leg_tibia_length"))
+    {
+        double *val = (double *) config_get(CONF_LEG_TIBIA_LENGTH);
+        printf("[Config] leg_tibia_length: %f\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "leg_joint_range"))
+    {
+        double *val = (double *) config_get(CONF_LEG_JOINT_RANGE);
+        printf("[Config] leg_joint_range: %f\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "leg_knee_zero"))
+    {
+        double *val = (double *) config_get(CONF_LEG_KNEE_ZERO);
+        printf("[Config] leg_knee_zero: %f\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "motion_library"))
+    {
+        const char *val = (const char *) config_get(CONF_MOTION_LIBRARY);
+        printf("[Config] motion_library: %s\n", val);
+        return;
+    }
+
+    if (str_equals(var_name, "rt_enable"))
+    {
+        bool *val = (bool *) config_get(CONF_RT_ENABLE);
+        printf("[Config] rt_enable: %s\n", *val ? "true" : "false");
+        return;
+    }
+
+    if (str_equals(var_name, "rt_mlockall"))
+    {
+        bool *val = (bool *) config_get(CONF_RT_MLOCKALL);
+        printf("[Config] rt_mlockall: %s\n", *val ? "true" : "false");
+        return;
+    }
+
+    if (str_equals(var_name, "rt_robot_priority"))
+    {
+        unsigned short *val = (unsigned short *) config_get(CONF_RT_ROBOT_PRIORITY);
+        printf("[Config] rt_robot_priority: %i\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "rt_robot_cpus"))
+    {
+        unsigned int *val = (unsigned int *) config_get(CONF_RT_ROBOT_CPUS);
+        printf("[Config] rt_robot_cpus: 0x%x\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "rt_keyfr_priority"))
+    {
+        unsigned short *val = (unsigned short *) config_get(CONF_RT_KEYFR_PRIORITY);
+        printf("[Config] rt_keyfr_priority: %i\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "rt_keyfr_cpus"))
+    {
+        unsigned int *val = (unsigned int *) config_get(CONF_RT_KEYFR_CPUS);
+        printf("[Config] rt_keyfr_cpus: 0x%x\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "rt_events_priority"))
+    {
+        unsigned short *val = (unsigned short *) config_get(CONF_RT_EVENTS_PRIORITY);
+        printf("[Config] rt_events_priority: %i\n", *val);
+        return;
+    }
+
+    if (str_equals(var_name, "rt_events_cpus"))
+    {
+        unsigned int *val = (unsigned int *) config_get(CONF_RT_EVENTS_CPUS);
+        printf("[Config] rt_events_cpus: 0x%x\n", *val);
+        return;
+    }
+
     if (str_equals(var_name, "walk_hip_delta"))
     {
         double *val = (double *) config_get(CONF_WALK_HIP_DELTA);
@@ -348,7 +788,7 @@ void promptcmd_cfg_get(char *args[], int arg_num)
         }        
 
         unsigned short index = (unsigned short) atoi(args[1]);
-        unsigned short *pins = config_get(CONF_SERVO_PINS);
+        JointDesc *joints = (JointDesc *) config_get(CONF_JOINTS);
 
         unsigned short *servos_num = (unsigned short *) config_get(CONF_SERVOS_NUM);
         if (index > *servos_num - 1)
@@ -357,7 +797,7 @@ void promptcmd_cfg_get(char *args[], int arg_num)
             return;
         }
 
-        printf("[Config] servo_pin@%d: %d\n", index, pins[index]);
+        printf("[Config] servo_pin@%d: %d\n", index, joints[index].channel);
         return ;
     }                                      
 
@@ -378,9 +818,34 @@ void promptcmd_cfg_get(char *args[], int arg_num)
             return;
         }        
 
-        ServoLimit *servo_limits = (ServoLimit *) config_get(CONF_SERVO_LIMITS);        
+        JointDesc *joints = (JointDesc *) config_get(CONF_JOINTS);
+
+        printf("[Config] servo_limit@%d: %d-%d\n", index, joints[index].limits.min, joints[index].limits.max);
+        return;
+    }
+
+    if (str_equals(var_name, "joint"))
+    {
+        if (arg_num < 2)
+        {
+            console_print("[ERROR] Incorrect number of params. Usage: cfg_get joint [index]");
+            return;
+        }
+
+        unsigned short index = (unsigned short) atoi(args[1]);
+
+        unsigned short *servos_num = (unsigned short *) config_get(CONF_SERVOS_NUM);
+        if (index > *servos_num - 1)
+        {
+            console_print("[ERROR] Provided index is greater than the number of servos.");
+            return;
+        }
+
+        JointDesc *joint = &((JointDesc *) config_get(CONF_JOINTS))[index];
 
-        printf("[Config] servo_limit@%d: %d-%d\n", index, servo_limits[index].min, servo_limits[index].max);
+        printf("[Config] joint@%d: %s, board: %d, channel: %d, inverted: %s, limits: %d-%d, tags: %s\n", 
+            index, joint->name, joint->board, joint->channel, joint->inverted ? "true" : "false", 
+            joint->limits.min, joint->limits.max, joint->tags);
         return;
     }
 
@@ -0,0 +1,123 @@
+#ifndef RING_BUFFER_DEF
+#define RING_BUFFER_DEF
+
+/*
+ File:          ring_buffer.c
+ Description:   Implementation of the lock-free single producer, single consumer 
+                FIFO ring of pointers.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+/* System includes */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <errno.h>
+
+/* Header */
+#include "ring_buffer.h"
+
+/*
+ head and tail only ever increase and are reduced modulo capacity on access. The 
+ producer stores an item before releasing tail and the consumer acquires tail before 
+ reading it, and the same pairing on head hands the slot back, so neither side locks.
+ */
+int ring_init(RingBuffer *ring, size_t capacity)
+{
+    if (!capacity)
+        return EINVAL;
+
+    ring->items = calloc(capacity, sizeof(void *));
+    if (!ring->items)
+        return ENOMEM;
+
+    ring->capacity = capacity;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+
+    return 0;
+}
+
+void ring_destroy(RingBuffer *ring)
+{
+    if (ring->items)
+        free(ring->items);
+    ring->items = NULL;
+
+    ring->capacity = 0;
+    atomic_store(&ring->head, 0);
+    atomic_store(&ring->tail, 0);
+}
+
+bool ring_push(RingBuffer *ring, void *data)
+{
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    if (tail - head >= ring->capacity)
+        return false;
+
+    ring->items[tail % ring->capacity] = data;
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+
+    return true;
+}
+
+void *ring_pop(RingBuffer *ring)
+{
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if (head == tail)
+        return NULL;
+
+    void *data = ring->items[head % ring->capacity];
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    return data;
+}
+
+void *ring_peek(RingBuffer *ring)
+{
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if (head == tail)
+        return NULL;
+
+    return ring->items[head % ring->capacity];
+}
+
+void *ring_peek_at(RingBuffer *ring, size_t n)
+{
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if (tail - head <= n)
+        return NULL;
+
+    return ring->items[(head + n) % ring->capacity];
+}
+
+/*
+ head is read first, and tail only ever gets further ahead of any earlier head, so the 
+ difference never goes negative. From a third thread, though, both sides may move between 
+ the two loads and the difference can overshoot; it is clamped so a snapshot never claims 
+ more than the ring holds, and ring_space never underflows.
+ */
+size_t ring_count(RingBuffer *ring)
+{
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    size_t count = tail - head;
+    return count > ring->capacity ? ring->capacity : count;
+}
+
+size_t ring_space(RingBuffer *ring)
+{
+    return ring->capacity - ring_count(ring);
+}
+
+#endif
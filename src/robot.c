@@ -8,19 +8,19 @@
  Author:        Matt Mumau
  */
 
-#define _POSIX_C_SOURCE 199309L
+#define _POSIX_C_SOURCE 200112L
 
 /* System includes */
 #include <sys/prctl.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <errno.h>
 #include <math.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 #include <pthread.h>
-
-/* Raspberry Pi libraries */
-#include <wiringPi.h>
-#include <pca9685.h>
+#include <semaphore.h>
 
 /* Application includes */
 #include "config_defaults.h"
@@ -28,54 +28,134 @@
 #include "config.h"
 #include "log.h"
 #include "utils.h"
+#include "rt_sched.h"
+#include "servo_driver.h"
+#include "servo_frame.h"
+#include "pca9685_i2c.h"
+#include "timing_stats.h"
 
 /* Header */
 #include "robot.h"
 
+/* A thread which flushes one board's frame each time the output loop signals it. */
+typedef struct RobotFlush {
+    pthread_t thread;
+    sem_t start;
+    sem_t done;
+    unsigned short board;
+    int sent;
+} RobotFlush;
+
 /* Forward decs */
 static void *robot_main(void *arg);
-static void robot_mvjoint(unsigned short joint, double val);
-static bool robot_jointinv(unsigned short joint);
-static unsigned short robot_mapsrv(double val, ServoLimit *servo_limit);
+static void *robot_flush_main(void *arg);
+static void robot_write_frame(unsigned short servos_num);
+static void robot_flush_boards();
+static void robot_start_flushers();
+static void robot_stop_flushers();
+static bool robot_refresh_due();
+static void robot_build_jointmap();
+static unsigned short robot_count_boards();
+static long long robot_period_ns();
+static void robot_sync_pwm(struct timespec *deadline, long long *period_ns);
+static double robot_limit_scale();
+static void robot_sleep_until(struct timespec *deadline);
+static void robot_log_tickstats();
 static void robot_destroy();
 
 static pthread_t    robot_thread;
+static bool         thread_started = false;
+static bool         driver_ready = false;
 static bool         running = true;
 static int          error;
-static int          pca_9685_fd;
-static double       *servo;
+static ServoDriver  *driver;
+static ServoFrame   joint_frame;
+static const AnimReal *servo;
+
+static unsigned short boards_num = 1;
+static unsigned short frame[DEFAULT_PCA_9685_BOARDS_MAX][SERVO_DRIVER_CHANNELS];
+static unsigned short written[DEFAULT_PCA_9685_BOARDS_MAX][SERVO_DRIVER_CHANNELS];
+static unsigned int dirty_mask[DEFAULT_PCA_9685_BOARDS_MAX];
+static RobotFlush flushers[DEFAULT_PCA_9685_BOARDS_MAX];
+static bool flushing = false;
+static unsigned short flushers_started = 0;
+static unsigned short refresh_count = 0;
+static bool refresh_pending = true;
+
+static JointMap *jointmap;
+static unsigned short jointmap_len = 0;
+static unsigned int jointmap_version;
+
+static atomic_llong tick_ns;
+// The hook is swapped without a lock; tick_seq is odd while a tick may be running it.
+static _Atomic(RobotTickHook) tick_hook = NULL;
+static atomic_uint tick_seq;
+
+static RobotTickStats tick_stats;
+static RobotWriteStats write_stats;
 
 void robot_init()
 {
-    unsigned int *pca_9685_pin_base = (unsigned int *) config_get(CONF_PCA_9685_PIN_BASE);
-    unsigned int *pca_9685_hertz = (unsigned int *) config_get(CONF_PCA_9685_HERTZ);
+    unsigned short *servo_driver = (unsigned short *) config_get(CONF_SERVO_DRIVER);
     unsigned short *servos_num = (unsigned short *) config_get(CONF_SERVOS_NUM);
 
-    pca_9685_fd = pca9685Setup(*pca_9685_pin_base, 0x40, *pca_9685_hertz);
-    if (pca_9685_fd < 0)
-        APP_ERROR("Could not get PCA-9685 file descriptor.", 1);
-    pca9685PWMReset(pca_9685_fd);
+    driver = srvdrv_get(*servo_driver);
+    if (!driver)
+        APP_ERROR("Unknown servo driver.", 1);
 
-    servo = calloc(*servos_num, sizeof(double));
-    if (!servo)
+    boards_num = robot_count_boards();
+
+    error = driver->init(boards_num);
+    if (error)
+        APP_ERROR("Could not initialize servo driver.", error);
+    driver_ready = true;
+    driver->reset();
+
+    error = srvframe_init(&joint_frame, *servos_num);
+    if (error)
+        APP_ERROR("Could not allocate memory.", error);
+    servo = srvframe_acquire(&joint_frame);
+
+    jointmap = calloc(*servos_num, sizeof(JointMap));
+    if (!jointmap)
         APP_ERROR("Could not allocate memory.", 1);
+    robot_build_jointmap();
+    robot_start_flushers();
+
+    atomic_store(&tick_ns, robot_period_ns());
 
     error = pthread_create(&robot_thread, NULL, robot_main, NULL);
     if (error)
         APP_ERROR("Could not initialize robot thread.", error);
+    thread_started = true;
+
+    rtsched_apply(robot_thread, RT_THREAD_ROBOT);
 }
 
+/* Also called after an init that failed part way, so only what was started is stopped. */
 void robot_halt()
 {   
     robot_reset();
-    robot_destroy();
     running = false;
 
-    error = pthread_join(robot_thread, NULL);
-    if (error)
-        log_error("Could not rejoin from robot thread.", error);
+    if (thread_started)
+    {
+        error = pthread_join(robot_thread, NULL);
+        if (error)
+            log_error("Could not rejoin from robot thread.", error);
+    }
+    thread_started = false;
 
-    pca9685PWMReset(pca_9685_fd);
+    robot_stop_flushers();
+    robot_log_tickstats();
+    robot_destroy();
+
+    if (driver_ready)
+    {
+        driver->reset();
+        driver->halt();
+    }
+    driver_ready = false;
 }
 
 void robot_reset()
@@ -83,109 +163,466 @@ void robot_reset()
     if (!servo)
         return;
 
-    unsigned short *servos_num = (unsigned short *) config_get(CONF_SERVOS_NUM);
-    for (unsigned short i = 0; i < *servos_num; i++)
-        servo[i] = 0.0; 
+    AnimReal *pos = robot_frame_begin();
+    for (size_t i = 0; i < joint_frame.len; i++)
+        pos[i] = 0; 
+
+    robot_frame_publish();
 }
 
-void robot_setservo(unsigned short pin, double val)
+AnimReal *robot_frame_begin()
 {
-    servo[pin] = val;
+    return srvframe_back(&joint_frame);
+}
+
+void robot_frame_publish()
+{
+    srvframe_publish(&joint_frame);
+}
+
+/*
+ The output loop marks tick_seq odd before it loads the hook, so once the new hook is 
+ stored, a tick seen odd here may still be running the old one and is waited out; any 
+ tick which starts later loads the new hook.
+ */
+/*
+ From inside a hook, the tick it would wait out is the caller's own, so it would wait 
+ forever; that call is refused and nothing changes.
+ */
+bool robot_set_tick_hook(RobotTickHook hook)
+{
+    struct timespec wait = { 0, 100000 };
+
+    if (thread_started && pthread_equal(pthread_self(), robot_thread))
+    {
+        log_event("[ROBT] The tick hook cannot be changed from inside a tick hook.");
+        return false;
+    }
+
+    atomic_store(&tick_hook, hook);
+
+    unsigned int seq = atomic_load(&tick_seq);
+    if (!(seq & 1))
+        return true;
+
+    while (atomic_load(&tick_seq) == seq)
+        nanosleep(&wait, NULL);
+
+    return true;
+}
+
+long long robot_tick_ns()
+{
+    return atomic_load(&tick_ns);
 }
 
 double robot_getservo(unsigned short pin)
 {
-    return servo[pin];
+    return ANIM_DOUBLE(servo[pin]);
 }
 
+void robot_get_writestats(RobotWriteStats *stats)
+{
+    *stats = write_stats;
+}
+
+void robot_get_tickstats(RobotTickStats *stats)
+{
+    *stats = tick_stats;
+}
+
+/*
+ The output loop sleeps until absolute deadlines spaced one robot tick apart, so 
+ time spent writing to the servos never accumulates as drift. A tick that runs past 
+ the following deadline is counted as an overrun, and the deadlines it missed are 
+ skipped rather than burst out back to back. A tick hook, when set, produces the 
+ frame for the deadline itself; taking it costs two atomic increments and a load.
+ */
 static void *robot_main(void *arg)
 {
     prctl(PR_SET_NAME, "PEABOT_ROBOT\0", NULL, NULL, NULL);
 
-    struct timespec time;
-    struct timespec last_time;
+    struct timespec deadline;
+    struct timespec woke;
+    struct timespec now;
+
+    long long period_ns = robot_period_ns();
+    long long late_ns;
+    long long missed;
+    RobotTickHook hook;
 
-    double tick = 0.0;
-    double diff;
-    
-    double *robot_tick = (double *) config_get(CONF_ROBOT_TICK);
     unsigned short *servos_num = (unsigned short *) config_get(CONF_SERVOS_NUM);
 
-    clock_gettime(CLOCK_MONOTONIC, &last_time);
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    robot_sync_pwm(&deadline, &period_ns);
+    atomic_store(&tick_ns, period_ns);
 
     while (running)
     {
-        clock_gettime(CLOCK_MONOTONIC, &time);
-        diff = utils_timediff(time, last_time);
-        last_time = time;
-        
-        tick += diff;
-        if (tick < *robot_tick)
+        utils_timespec_addns(&deadline, period_ns);
+        robot_sleep_until(&deadline);
+        clock_gettime(CLOCK_MONOTONIC, &woke);
+
+        atomic_fetch_add(&tick_seq, 1);
+        hook = atomic_load(&tick_hook);
+        if (hook)
+            hook(&deadline);
+        atomic_fetch_add(&tick_seq, 1);
+
+        servo = srvframe_acquire(&joint_frame);
+        robot_write_frame(*servos_num);
+        tick_stats.ticks++;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        tmstats_record(TMSTATS_ROBOT_LATENESS, utils_timediff_ns(woke, deadline));
+        tmstats_record(TMSTATS_ROBOT_TICK, utils_timediff_ns(now, woke));
+
+        late_ns = utils_timediff_ns(now, deadline);
+        if (late_ns < period_ns)
             continue;
 
-        tick = 0.0;
+        missed = late_ns / period_ns;
+        tick_stats.overruns++;
+        tick_stats.skipped += (unsigned long) missed;
+        utils_timespec_addns(&deadline, missed * period_ns);
+    }
+
+    return (void *) NULL;
+}
+
+/*
+ Limits given in counts at pca_9685_limits_hertz are rescaled so the pulse widths stay 
+ the same at the running frequency, e.g. 4x the counts when moving from 50 Hz to 200 Hz.
+ */
+static double robot_limit_scale()
+{
+    unsigned int *hertz = (unsigned int *) config_get(CONF_PCA_9685_HERTZ);
+    unsigned int *limits_hertz = (unsigned int *) config_get(CONF_PCA_9685_LIMITS_HERTZ);
+
+    if (!*limits_hertz || *limits_hertz == *hertz)
+        return 1.0;
+
+    return (double) pcai2c_period_ns(*limits_hertz) / (double) pcai2c_period_ns(*hertz);
+}
+
+static long long robot_period_ns()
+{
+    double *robot_tick = (double *) config_get(CONF_ROBOT_TICK);
+    double tick = *robot_tick > 0.0 ? *robot_tick : DEFAULT_ROBOT_TICK;
+
+    return (long long) llround(tick * 1000000000.0);
+}
+
+/*
+ With robot_pwm_sync, the tick becomes the driver's PWM frame period, and the deadlines 
+ are moved so each write lands robot_pwm_lead ahead of a frame starting. Both come from 
+ board 0 alone: the phase from when its counter was restarted, the period from its 
+ prescaler and a nominal 25 MHz oscillator. The chip's counter cannot be read back, so 
+ neither is ever corrected. The internal oscillator is only good to several percent, 
+ which walks the writes a whole frame off the real one within seconds; the lead only 
+ holds for long on a board clocked from an accurate external source at 25 MHz. Further 
+ boards run off their own oscillators and are not synchronized at all.
+ */
+static void robot_sync_pwm(struct timespec *deadline, long long *period_ns)
+{
+    bool *pwm_sync = (bool *) config_get(CONF_ROBOT_PWM_SYNC);
+    double *pwm_lead = (double *) config_get(CONF_ROBOT_PWM_LEAD);
+
+    struct timespec frame_start;
+    long long frame_ns;
+    char msg[LOG_LINE_MAXLEN];
+
+    if (!*pwm_sync)
+        return;
 
-        for (unsigned short i = 0; i < *servos_num; i++)
-            robot_mvjoint(i, servo[i]); 
+    if (driver->frame_timing(&frame_ns, &frame_start) || frame_ns <= 0)
+    {
+        log_event("[ROBT] PWM frame timing unavailable from the servo driver; keeping robot_tick.");
+        return;
+    }
+
+    long long lead_ns = llround(*pwm_lead * 1000000000.0);
+    if (lead_ns < 0 || lead_ns >= frame_ns)
+        lead_ns = 0;
+
+    // The loop adds a period before its first sleep, so start one frame back.
+    long long elapsed_ns = utils_timediff_ns(*deadline, frame_start);
+    long long frames = elapsed_ns > 0 ? elapsed_ns / frame_ns : 0;
+
+    *deadline = frame_start;
+    utils_timespec_addns(deadline, frames * frame_ns - lead_ns);
+    *period_ns = frame_ns;
+
+    snprintf(msg, sizeof(msg), "[ROBT] Output synchronized to board 0's %.3f Hz PWM frame, writing %lld us ahead of it.", 
+        1000000000.0 / frame_ns, lead_ns / 1000);
+    log_event(msg);
+
+    if (boards_num > 1)
+        log_event("[ROBT] Only board 0 is synchronized; the other boards' frames drift freely.");
+}
+
+static void robot_sleep_until(struct timespec *deadline)
+{
+    int retval;
+
+    do
+        retval = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, deadline, NULL);
+    while (retval == EINTR && running);
+}
+
+/*
+ Only channels whose mapped value differs from the last one written are marked 
+ dirty, unless a periodic full refresh is due; the driver decides how to send them. 
+ The mapping itself is a clamp and a fixed-point multiply-add per joint.
+ */
+static void robot_write_frame(unsigned short servos_num)
+{
+    if (config_get_version() != jointmap_version)
+        robot_build_jointmap();
+
+    long long map_start = tmstats_now();
+    unsigned int refresh = robot_refresh_due();
+    unsigned int any_dirty = 0;
+    unsigned short mapped_val;
+    unsigned short *board_written;
+    AnimReal val;
+    JointMap *map;
+
+    for (unsigned short b = 0; b < boards_num; b++)
+        dirty_mask[b] = 0;
+
+    for (unsigned short i = 0; i < jointmap_len; i++)
+    {
+        map = &jointmap[i];
+        board_written = written[map->board];
+
+        val = servo[map->joint];
+        val = val > ANIM_ONE ? ANIM_ONE : val;
+        val = val < -ANIM_ONE ? -ANIM_ONE : val;
+
+        mapped_val = (unsigned short) ((map->offset + map->scale * ANIM_TO_Q15(val)) >> ROBOT_JOINT_SHIFT);
+        frame[map->board][map->pin] = mapped_val;
+
+        dirty_mask[map->board] |= (refresh | (board_written[map->pin] != mapped_val)) << map->pin;
+    }
+
+    for (unsigned short b = 0; b < boards_num; b++)
+        any_dirty |= dirty_mask[b];
+
+    write_stats.frame_channels += servos_num;
+
+    long long write_start = tmstats_now();
+    tmstats_record(TMSTATS_ROBOT_MAP, write_start - map_start);
+
+    if (!any_dirty)
+    {
+        write_stats.idle_ticks++;
+        return;
+    }
+
+    robot_flush_boards();
+    tmstats_record(TMSTATS_ROBOT_WRITE, tmstats_now() - write_start);
+}
+
+/*
+ Every board but the first is handed to its own flush thread, while the output loop 
+ writes the first one itself; the tick then waits for all of them before accounting.
+ */
+static void robot_flush_boards()
+{
+    RobotFlush *flush;
+
+    for (unsigned short b = 1; b < boards_num; b++)
+    {
+        if (dirty_mask[b])
+            sem_post(&flushers[b].start);
+    }
+
+    flushers[0].sent = driver->write(0, frame[0], dirty_mask[0]);
+
+    for (unsigned short b = 0; b < boards_num; b++)
+    {
+        if (!dirty_mask[b])
+            continue;
+
+        flush = &flushers[b];
+        if (b > 0)
+            sem_wait(&flush->done);
+
+        if (flush->sent < 0)
+        {
+            tick_stats.write_errors++;
+            refresh_pending = true;
+            continue;
+        }
+
+        for (unsigned short j = 0; j < SERVO_DRIVER_CHANNELS; j++)
+        {
+            if (dirty_mask[b] & (1U << j))
+                written[b][j] = frame[b][j];
+        }
+
+        write_stats.transfers++;
+        write_stats.channel_writes += flush->sent;
+    }
+}
+
+static void *robot_flush_main(void *arg)
+{
+    prctl(PR_SET_NAME, "PEABOT_FLUSH\0", NULL, NULL, NULL);
+
+    RobotFlush *flush = (RobotFlush *) arg;
+
+    while (true)
+    {
+        sem_wait(&flush->start);
+        if (!flushing)
+            break;
+
+        flush->sent = driver->write(flush->board, frame[flush->board], dirty_mask[flush->board]);
+        sem_post(&flush->done);
     }
 
     return (void *) NULL;
 }
 
-static void robot_mvjoint(unsigned short joint, double val)
+static void robot_start_flushers()
 {
-    val = robot_jointinv(joint) ? -val : val;
+    RobotFlush *flush;
 
-    unsigned short *pin_data = (unsigned short *) config_get(CONF_SERVO_PINS);
-    unsigned short pin = pin_data[joint];
+    flushing = true;
+    for (unsigned short b = 1; b < boards_num; b++)
+    {
+        flush = &flushers[b];
+        flush->board = b;
+        sem_init(&flush->start, 0, 0);
+        sem_init(&flush->done, 0, 0);
 
-    ServoLimit *servo_limits = (ServoLimit *) config_get(CONF_SERVO_LIMITS);
+        error = pthread_create(&flush->thread, NULL, robot_flush_main, (void *) flush);
+        if (error)
+            APP_ERROR("Could not initialize board flush thread.", error);
+        flushers_started = b;
 
-    unsigned short mapped_val = robot_mapsrv(val, &(servo_limits[joint]));
+        rtsched_apply(flush->thread, RT_THREAD_ROBOT);
+    }
+}
 
-    unsigned int *pca_9685_pin_base = (unsigned int *) config_get(CONF_PCA_9685_PIN_BASE);
-    pin += *pca_9685_pin_base;
+static void robot_stop_flushers()
+{
+    flushing = false;
+    for (unsigned short b = 1; b <= flushers_started; b++)
+    {
+        sem_post(&flushers[b].start);
 
-    pwmWrite(pin, mapped_val);
+        error = pthread_join(flushers[b].thread, NULL);
+        if (error)
+            log_error("Could not rejoin from board flush thread.", error);
+
+        sem_destroy(&flushers[b].start);
+        sem_destroy(&flushers[b].done);
+    }
+    flushers_started = 0;
 }
 
-static bool robot_jointinv(unsigned short joint)
+/*
+ Joints on boards or pins the driver has no channel for are left out of the table, and 
+ a joint whose limits are empty maps to 0 as before. The offset carries the midpoint of 
+ the limits plus half a count for rounding; the scale is the span, negated for inverted joints.
+ */
+static void robot_build_jointmap()
 {
-    if (joint == SERVO_INDEX_FRONT_LEFT_KNEE ||
-        joint == SERVO_INDEX_FRONT_LEFT_HIP ||
-        joint == SERVO_INDEX_BACK_RIGHT_KNEE ||
-        joint == SERVO_INDEX_BACK_RIGHT_HIP)
-        return true;
+    unsigned short *servos_num = (unsigned short *) config_get(CONF_SERVOS_NUM);
+    JointDesc *joints = (JointDesc *) config_get(CONF_JOINTS);
+
+    jointmap_version = config_get_version();
+    jointmap_len = 0;
+
+    double limit_scale = robot_limit_scale();
+    long min, max;
+
+    JointDesc *joint;
+    JointMap *map;
+
+    for (unsigned short i = 0; i < *servos_num; i++)
+    {
+        joint = &joints[i];
+        if (joint->board >= boards_num || joint->channel >= SERVO_DRIVER_CHANNELS)
+            continue;
+
+        map = &jointmap[jointmap_len++];
+        map->joint = i;
+        map->board = joint->board;
+        map->pin = joint->channel;
+        map->offset = 0;
+        map->scale = 0;
+
+        if (joint->limits.min >= joint->limits.max)
+            continue;
 
-    return false;
+        min = lround(joint->limits.min * limit_scale);
+        max = lround(joint->limits.max * limit_scale);
+        if (max >= PCA9685_COUNT_MAX)
+            max = PCA9685_COUNT_MAX - 1;
+        if (min > max)
+            min = max;
+
+        map->offset = ((min + max) << (ROBOT_JOINT_SHIFT - 1)) + (1 << (ROBOT_JOINT_SHIFT - 1));
+        map->scale = max - min;
+        if (joint->inverted)
+            map->scale = -map->scale;
+    }
+
+    refresh_pending = true;
 }
 
-static unsigned short robot_mapsrv(double val, ServoLimit *servo_limit)
+static unsigned short robot_count_boards()
 {
-    if (servo_limit->min >= servo_limit->max)
-        return 0.0;
+    unsigned short *servos_num = (unsigned short *) config_get(CONF_SERVOS_NUM);
+    JointDesc *joints = (JointDesc *) config_get(CONF_JOINTS);
+    unsigned short count = 1;
 
-    if (val > 1.0)
-        val = 1.0;
-    if (val < -1.0)
-        val = -1.0;
+    for (unsigned short i = 0; i < *servos_num; i++)
+    {
+        if (joints[i].board >= count)
+            count = joints[i].board + 1;
+    }
+
+    return count;
+}
+
+static bool robot_refresh_due()
+{
+    unsigned short *refresh_ticks = (unsigned short *) config_get(CONF_ROBOT_REFRESH_TICKS);
 
-    double val_abs = fabs(val);
-    double half = (servo_limit->max - servo_limit->min) / 2.0;
-    double midway = (double) servo_limit->min + half;
-    double diff = half * val_abs;
+    if (*refresh_ticks && ++refresh_count >= *refresh_ticks)
+        refresh_pending = true;
 
-    if (val < 0.0)
-        return (unsigned short) round(midway - diff);
-    
-    return (unsigned short) round(midway + diff);
+    if (!refresh_pending)
+        return false;
+
+    refresh_pending = false;
+    refresh_count = 0;
+    write_stats.full_refreshes++;
+    return true;
+}
+
+static void robot_log_tickstats()
+{
+    char msg[LOG_LINE_MAXLEN];
+    snprintf(msg, sizeof(msg), "[ROBT] Output loop stopped. (ticks: %lu, overruns: %lu, skipped: %lu, write errors: %lu)", 
+        tick_stats.ticks, tick_stats.overruns, tick_stats.skipped, tick_stats.write_errors);
+    log_event(msg);
 }
 
 static void robot_destroy()
 {
-    if (servo)
-        free(servo);
+    if (jointmap)
+        free(jointmap);
+    jointmap = NULL;
+    jointmap_len = 0;
+
     servo = NULL;
+    srvframe_destroy(&joint_frame);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,179 @@
+#ifndef RT_SCHED_DEF
+#define RT_SCHED_DEF
+
+/*
+ File:          rt_sched.c
+ Description:   Implementation of real-time scheduling for Peabot's control threads.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#define _GNU_SOURCE
+
+/* System includes */
+#include <stdio.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <errno.h>
+
+/* Application includes */
+#include "config_defaults.h"
+#include "config.h"
+#include "log.h"
+#include "console.h"
+
+/* Header */
+#include "rt_sched.h"
+
+typedef struct RTSchedResult {
+    bool applied;
+    int sched_error;
+    int affinity_error;
+    unsigned short priority;
+    unsigned int cpus;
+} RTSchedResult;
+
+/* Forward decs */
+static void rtsched_get_config(unsigned short rt_thread, unsigned short *priority, unsigned int *cpus);
+static const char *rtsched_getname(unsigned short rt_thread);
+static void rtsched_print(const char *msg);
+
+static RTSchedResult results[RT_THREAD_NUM];
+static bool memory_locked = false;
+static int mlock_error = 0;
+
+void rtsched_apply(pthread_t thread, unsigned short rt_thread)
+{
+    bool *rt_enable = (bool *) config_get(CONF_RT_ENABLE);
+    if (!*rt_enable || rt_thread >= RT_THREAD_NUM)
+        return;
+
+    RTSchedResult *result = &results[rt_thread];
+    rtsched_get_config(rt_thread, &result->priority, &result->cpus);
+
+    int min_priority = sched_get_priority_min(SCHED_FIFO);
+    int max_priority = sched_get_priority_max(SCHED_FIFO);
+    if (result->priority < min_priority)
+        result->priority = min_priority;
+    if (result->priority > max_priority)
+        result->priority = max_priority;
+
+    struct sched_param param;
+    param.sched_priority = result->priority;
+    result->sched_error = pthread_setschedparam(thread, SCHED_FIFO, &param);
+
+    result->affinity_error = 0;
+    if (result->cpus)
+    {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (unsigned int cpu = 0; cpu < sizeof(result->cpus) * 8; cpu++)
+        {
+            if (result->cpus & (1U << cpu))
+                CPU_SET(cpu, &cpu_set);
+        }
+
+        result->affinity_error = pthread_setaffinity_np(thread, sizeof(cpu_set), &cpu_set);
+    }
+
+    result->applied = true;
+}
+
+void rtsched_lock_memory()
+{
+    bool *rt_enable = (bool *) config_get(CONF_RT_ENABLE);
+    bool *rt_mlockall = (bool *) config_get(CONF_RT_MLOCKALL);
+    if (!*rt_enable || !*rt_mlockall)
+        return;
+
+    // Only current mappings are locked; locking future ones would also pin the 
+    // stack of every detached HTTP request thread.
+    if (mlockall(MCL_CURRENT) == 0)
+        memory_locked = true;
+    else
+        mlock_error = errno;
+}
+
+void rtsched_report()
+{
+    char msg[LOG_LINE_MAXLEN];
+
+    bool *rt_enable = (bool *) config_get(CONF_RT_ENABLE);
+    if (!*rt_enable)
+    {
+        rtsched_print("[RT] Real-time mode disabled; control threads use default scheduling.");
+        return;
+    }
+
+    for (unsigned short i = 0; i < RT_THREAD_NUM; i++)
+    {
+        RTSchedResult *result = &results[i];
+
+        if (!result->applied)
+            snprintf(msg, sizeof(msg), "[RT] %s: not started.", rtsched_getname(i));
+        else if (result->sched_error)
+            snprintf(msg, sizeof(msg), "[RT] %s: SCHED_FIFO %d failed (e:%d), affinity 0x%x %s.", 
+                rtsched_getname(i), result->priority, result->sched_error, result->cpus, 
+                result->affinity_error ? "failed" : "applied");
+        else
+            snprintf(msg, sizeof(msg), "[RT] %s: SCHED_FIFO %d, affinity %s0x%x%s.", 
+                rtsched_getname(i), result->priority, result->cpus ? "" : "(all) ", result->cpus, 
+                result->affinity_error ? " failed" : "");
+
+        rtsched_print(msg);
+    }
+
+    bool *rt_mlockall = (bool *) config_get(CONF_RT_MLOCKALL);
+    if (!*rt_mlockall)
+        snprintf(msg, sizeof(msg), "[RT] Memory locking disabled.");
+    else if (memory_locked)
+        snprintf(msg, sizeof(msg), "[RT] Memory locked.");
+    else
+        snprintf(msg, sizeof(msg), "[RT] Memory locking failed. (e:%d)", mlock_error);
+
+    rtsched_print(msg);
+}
+
+static void rtsched_get_config(unsigned short rt_thread, unsigned short *priority, unsigned int *cpus)
+{
+    switch (rt_thread)
+    {
+        case RT_THREAD_ROBOT:
+            *priority = *((unsigned short *) config_get(CONF_RT_ROBOT_PRIORITY));
+            *cpus = *((unsigned int *) config_get(CONF_RT_ROBOT_CPUS));
+            break;
+        case RT_THREAD_KEYFR:
+            *priority = *((unsigned short *) config_get(CONF_RT_KEYFR_PRIORITY));
+            *cpus = *((unsigned int *) config_get(CONF_RT_KEYFR_CPUS));
+            break;
+        case RT_THREAD_EVENTS:
+            *priority = *((unsigned short *) config_get(CONF_RT_EVENTS_PRIORITY));
+            *cpus = *((unsigned int *) config_get(CONF_RT_EVENTS_CPUS));
+            break;
+    }
+}
+
+static const char *rtsched_getname(unsigned short rt_thread)
+{
+    switch (rt_thread)
+    {
+        case RT_THREAD_ROBOT:
+            return "PEABOT_ROBOT";
+        case RT_THREAD_KEYFR:
+            return "PEABOT_KEYFR";
+        case RT_THREAD_EVENTS:
+            return "PEABOT_EVENTS";
+    }
+
+    return "UNKNOWN";
+}
+
+static void rtsched_print(const char *msg)
+{
+    console_print(msg);
+    log_event(msg);
+}
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef SERVO_DRIVER_DEF
+#define SERVO_DRIVER_DEF
+
+/*
+ File:          servo_driver.c
+ Description:   Selection of the backends which output servo frames.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+/* System includes */
+#include <stdlib.h>
+#include <stdbool.h>
+
+/* Application includes */
+#include "string_utils.h"
+#include "driver_pca9685.h"
+#include "driver_sim.h"
+
+/* Header */
+#include "servo_driver.h"
+
+static ServoDriver drivers[] = {
+    { "pca9685", drvpca_init, drvpca_write, drvpca_frame_timing, drvpca_reset, drvpca_halt },
+    { "sim", drvsim_init, drvsim_write, drvsim_frame_timing, drvsim_reset, drvsim_halt }
+};
+
+ServoDriver *srvdrv_get(unsigned short driver_type)
+{
+    if (driver_type >= sizeof(drivers) / sizeof(drivers[0]))
+        return NULL;
+
+    return &drivers[driver_type];
+}
+
+unsigned short srvdrv_str_to_type(const char *str)
+{
+    if (str_equals(str, "sim"))
+        return SERVO_DRIVER_SIM;
+
+    return SERVO_DRIVER_PCA9685;
+}
+
+const char *srvdrv_type_to_str(unsigned short driver_type)
+{
+    ServoDriver *driver = srvdrv_get(driver_type);
+    if (!driver)
+        return "INVALID";
+
+    return driver->name;
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef SERVO_FRAME_DEF
+#define SERVO_FRAME_DEF
+
+/*
+ File:          servo_frame.c
+ Description:   Lock-free triple buffer handing whole servo frames from a single 
+                producer thread to a single consumer thread.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+/* System includes */
+#include <stdlib.h>
+#include <errno.h>
+#include <stdatomic.h>
+
+/* Application includes */
+#include "precision.h"
+
+/* Header */
+#include "servo_frame.h"
+
+/*
+ Each side owns one buffer outright and the third sits in latest. The producer 
+ swaps its filled buffer into latest with the fresh bit set, the consumer swaps 
+ its buffer for latest only when the bit is set, so neither side waits and the 
+ consumer never sees a partially written frame.
+ */
+int srvframe_init(ServoFrame *frame, size_t len)
+{
+    for (unsigned int i = 0; i < SERVO_FRAME_BUFFERS; i++)
+    {
+        frame->buffer[i] = calloc(len, sizeof(AnimReal));
+        if (!frame->buffer[i])
+        {
+            srvframe_destroy(frame);
+            return ENOMEM;
+        }
+    }
+
+    frame->len = len;
+    frame->back = 0;
+    frame->front = 1;
+    atomic_init(&frame->latest, 2);
+
+    return 0;
+}
+
+void srvframe_destroy(ServoFrame *frame)
+{
+    for (unsigned int i = 0; i < SERVO_FRAME_BUFFERS; i++)
+    {
+        if (frame->buffer[i])
+            free(frame->buffer[i]);
+        frame->buffer[i] = NULL;
+    }
+}
+
+AnimReal *srvframe_back(ServoFrame *frame)
+{
+    return frame->buffer[frame->back];
+}
+
+void srvframe_publish(ServoFrame *frame)
+{
+    unsigned int prev = atomic_exchange_explicit(&frame->latest, frame->back | SERVO_FRAME_FRESH, memory_order_acq_rel);
+    frame->back = prev & SERVO_FRAME_INDEX;
+}
+
+const AnimReal *srvframe_acquire(ServoFrame *frame)
+{
+    if (!(atomic_load_explicit(&frame->latest, memory_order_relaxed) & SERVO_FRAME_FRESH))
+        return frame->buffer[frame->front];
+
+    unsigned int prev = atomic_exchange_explicit(&frame->latest, frame->front, memory_order_acq_rel);
+    frame->front = prev & SERVO_FRAME_INDEX;
+
+    return frame->buffer[frame->front];
+}
+
+#endif
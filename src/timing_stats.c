@@ -0,0 +1,169 @@
+#ifndef TIMING_STATS_DEF
+#define TIMING_STATS_DEF
+
+/*
+ File:          timing_stats.c
+ Description:   Lock-free log-linear latency histograms for the control loop stages.
+ Created:       October 17, 2026
+ Author:        Matt Mumau
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+/* System includes */
+#include <stdatomic.h>
+#include <time.h>
+
+/* Header */
+#include "timing_stats.h"
+
+/* Forward decs */
+static unsigned int tmstats_bucket(unsigned long long nsec);
+static double tmstats_bucket_mid(unsigned int bucket);
+static double tmstats_percentile(unsigned long *buckets, unsigned long long count, double perc);
+
+static TimingHist hists[TMSTATS_NUM];
+
+static const char *stage_names[TMSTATS_NUM] = {
+    "robot_lateness",
+    "robot_tick",
+    "robot_map",
+    "robot_write",
+    "keyfr_eval",
+    "keyfr_lateness"
+};
+
+long long tmstats_now()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (long long) now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/*
+ Every counter is updated with relaxed atomics; a reader may see a sample in the count 
+ before its bucket, which only blurs a summary taken mid-update.
+ */
+void tmstats_record(unsigned short stage, long long nsec)
+{
+    if (stage >= TMSTATS_NUM)
+        return;
+
+    if (nsec < 0)
+        nsec = 0;
+
+    TimingHist *hist = &hists[stage];
+    unsigned long long val = (unsigned long long) nsec;
+    unsigned long long max = atomic_load_explicit(&hist->max, memory_order_relaxed);
+
+    atomic_fetch_add_explicit(&hist->buckets[tmstats_bucket(val)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&hist->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&hist->sum, val, memory_order_relaxed);
+
+    while (val > max && !atomic_compare_exchange_weak_explicit(&hist->max, &max, val, memory_order_relaxed, memory_order_relaxed))
+        ;
+}
+
+void tmstats_get(unsigned short stage, TimingSummary *summary)
+{
+    unsigned long buckets[TMSTATS_BUCKETS];
+
+    summary->count = 0;
+    summary->mean = summary->p50 = summary->p99 = summary->max = 0.0;
+
+    if (stage >= TMSTATS_NUM)
+        return;
+
+    TimingHist *hist = &hists[stage];
+    unsigned long long count = 0;
+
+    for (unsigned int i = 0; i < TMSTATS_BUCKETS; i++)
+    {
+        buckets[i] = atomic_load_explicit(&hist->buckets[i], memory_order_relaxed);
+        count += buckets[i];
+    }
+
+    if (!count)
+        return;
+
+    summary->count = count;
+    summary->mean = atomic_load_explicit(&hist->sum, memory_order_relaxed) / (double) count / 1000.0;
+    summary->p50 = tmstats_percentile(buckets, count, 0.50) / 1000.0;
+    summary->p99 = tmstats_percentile(buckets, count, 0.99) / 1000.0;
+    summary->max = atomic_load_explicit(&hist->max, memory_order_relaxed) / 1000.0;
+}
+
+void tmstats_reset()
+{
+    TimingHist *hist;
+
+    for (unsigned short i = 0; i < TMSTATS_NUM; i++)
+    {
+        hist = &hists[i];
+        for (unsigned int j = 0; j < TMSTATS_BUCKETS; j++)
+            atomic_store_explicit(&hist->buckets[j], 0, memory_order_relaxed);
+
+        atomic_store_explicit(&hist->count, 0, memory_order_relaxed);
+        atomic_store_explicit(&hist->sum, 0, memory_order_relaxed);
+        atomic_store_explicit(&hist->max, 0, memory_order_relaxed);
+    }
+}
+
+const char *tmstats_stage_name(unsigned short stage)
+{
+    if (stage >= TMSTATS_NUM)
+        return "INVALID";
+
+    return stage_names[stage];
+}
+
+/*
+ Values below TMSTATS_SUB_BUCKETS get a bucket each; above that, the bucket is picked 
+ by the position of the highest set bit and the TMSTATS_SUB_BITS bits below it.
+ */
+static unsigned int tmstats_bucket(unsigned long long nsec)
+{
+    if (nsec < TMSTATS_SUB_BUCKETS)
+        return (unsigned int) nsec;
+
+    if (nsec >= (1ULL << (TMSTATS_MAX_BITS + 1)))
+        nsec = (1ULL << (TMSTATS_MAX_BITS + 1)) - 1;
+
+    unsigned int msb = 63 - __builtin_clzll(nsec);
+    unsigned int sub = (nsec >> (msb - TMSTATS_SUB_BITS)) & (TMSTATS_SUB_BUCKETS - 1);
+
+    return (msb - TMSTATS_SUB_BITS + 1) * TMSTATS_SUB_BUCKETS + sub;
+}
+
+static double tmstats_bucket_mid(unsigned int bucket)
+{
+    if (bucket < TMSTATS_SUB_BUCKETS)
+        return bucket;
+
+    unsigned int msb = bucket / TMSTATS_SUB_BUCKETS + TMSTATS_SUB_BITS - 1;
+    unsigned int sub = bucket % TMSTATS_SUB_BUCKETS;
+    double width = (double) (1ULL << (msb - TMSTATS_SUB_BITS));
+
+    return (TMSTATS_SUB_BUCKETS + sub) * width + width / 2.0;
+}
+
+static double tmstats_percentile(unsigned long *buckets, unsigned long long count, double perc)
+{
+    unsigned long long rank = (unsigned long long) (perc * count);
+    unsigned long long seen = 0;
+
+    if (rank >= count)
+        rank = count - 1;
+
+    for (unsigned int i = 0; i < TMSTATS_BUCKETS; i++)
+    {
+        seen += buckets[i];
+        if (seen > rank)
+            return tmstats_bucket_mid(i);
+    }
+
+    return 0.0;
+}
+
+#endif
@@ -20,7 +20,9 @@
 #include <string.h>
 
 /* Raspberry Pi includes */
+#ifndef PEABOT_HOST
 #include <wiringPi.h>
+#endif
 
 /* Application includes */
 #include "main.h"
@@ -46,10 +48,13 @@ void usd_sensor_init()
     if (error)
         APP_ERROR("Could not initialize USD sensor thread.", error);
 
+    // Host builds have no GPIO; the sensor thread exits and the distance stays at 0.
+    #ifndef PEABOT_HOST
     pinMode(DEFAULT_HRC_SR04_TRIGGER_PIN, OUTPUT);
     pinMode(DEFAULT_HRC_SR04_ECHO_PIN, INPUT);    
 
     digitalWrite(DEFAULT_HRC_SR04_TRIGGER_PIN, LOW);
+    #endif
 }
 
 void usd_sensor_halt()
@@ -69,6 +74,8 @@ static void *usd_sensor_main(void *arg)
 {
     prctl(PR_SET_NAME, "PEABOT_USD\0", NULL, NULL, NULL);
 
+    #ifndef PEABOT_HOST
+
     double new_distance;
 
     unsigned int timeout, max_timeout;
@@ -117,6 +124,7 @@ static void *usd_sensor_main(void *arg)
 
         delayMicroseconds(100000);
     }
+    #endif
 
     return (void *) NULL;
 }
@@ -46,4 +46,24 @@ double utils_timespec_to_secs(struct timespec ts)
     return ((double) ts.tv_sec) + ((double) ((double) ts.tv_nsec / 1000000000.0));
 }
 
+void utils_timespec_addns(struct timespec *ts, long long nsec)
+{
+    nsec += ts->tv_nsec;
+
+    ts->tv_sec += (time_t) (nsec / 1000000000LL);
+    ts->tv_nsec = (long) (nsec % 1000000000LL);
+
+    if (ts->tv_nsec < 0)
+    {
+        ts->tv_sec--;
+        ts->tv_nsec += 1000000000L;
+    }
+}
+
+long long utils_timediff_ns(struct timespec end_time, struct timespec start_time)
+{
+    return ((long long) (end_time.tv_sec - start_time.tv_sec)) * 1000000000LL +
+        (long long) (end_time.tv_nsec - start_time.tv_nsec);
+}
+
 #endif
\ No newline at end of file